@@ -0,0 +1,125 @@
+#include <xlnt/xlnt.hpp>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <helpers/path_helper.hpp>
+
+namespace {
+
+// Resident set size of this process in bytes, or 0 where it can't be determined.
+std::size_t resident_set_size()
+{
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, 6, "VmRSS:") == 0)
+        {
+            return std::stoull(line.substr(6)) * 1024;
+        }
+    }
+#endif
+    return 0;
+}
+
+void report(const std::string &label, std::size_t before, std::size_t after, std::size_t cells)
+{
+    const auto used = after > before ? after - before : 0;
+
+    std::cout << label << ": " << cells << " cells, "
+              << used / (1024 * 1024) << " MiB, "
+              << (cells > 0 ? static_cast<double>(used) / static_cast<double>(cells) : 0.0)
+              << " bytes/cell\n";
+}
+
+void run_numeric_sheet_test(xlnt::row_t rows, xlnt::column_t::index_t columns)
+{
+    const auto before = resident_set_size();
+
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+
+    for (xlnt::row_t row = 1; row <= rows; ++row)
+    {
+        for (xlnt::column_t::index_t column = 1; column <= columns; ++column)
+        {
+            ws.cell(column, row).value(static_cast<double>(row) * column);
+        }
+    }
+
+    report("numeric", before, resident_set_size(), static_cast<std::size_t>(rows) * columns);
+}
+
+void run_string_sheet_test(xlnt::row_t rows, xlnt::column_t::index_t columns)
+{
+    const auto before = resident_set_size();
+
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+
+    for (xlnt::row_t row = 1; row <= rows; ++row)
+    {
+        for (xlnt::column_t::index_t column = 1; column <= columns; ++column)
+        {
+            ws.cell(column, row).value("value " + std::to_string(row % 1000));
+        }
+    }
+
+    report("shared string", before, resident_set_size(), static_cast<std::size_t>(rows) * columns);
+}
+
+void run_load_test(const xlnt::path &file)
+{
+    const auto before = resident_set_size();
+
+    xlnt::workbook wb;
+    wb.load(file);
+
+    std::size_t cells = 0;
+    for (auto ws : wb)
+    {
+        for (auto row : ws.rows())
+        {
+            for (auto cell : row)
+            {
+                static_cast<void>(cell);
+                ++cells;
+            }
+        }
+    }
+
+    report(file.filename(), before, resident_set_size(), cells);
+}
+
+} // namespace
+
+// Memory freed by one test is usually kept by the allocator and reused by the
+// next, so pass a test name (numeric, string or load) to measure it in a fresh process.
+int main(int argc, char **argv)
+{
+    if (resident_set_size() == 0)
+    {
+        std::cout << "resident set size isn't available on this platform\n";
+        return 0;
+    }
+
+    const auto test = std::string(argc > 1 ? argv[1] : "");
+
+    if (test.empty() || test == "numeric")
+    {
+        run_numeric_sheet_test(100000, 10);
+    }
+
+    if (test.empty() || test == "string")
+    {
+        run_string_sheet_test(100000, 10);
+    }
+
+    if (test.empty() || test == "load")
+    {
+        run_load_test(path_helper::benchmark_file("large.xlsx"));
+    }
+}
@@ -0,0 +1,99 @@
+// Encrypted workbooks are decrypted and encrypted in 4096 byte segments with AES,
+// ECB for standard encryption and CBC for agile encryption. This compares the
+// portable table based implementation with the one using the processor's AES
+// instructions, which the library picks at runtime when they're available.
+
+#include "benchmark/benchmark.h"
+#include <cstdint>
+#include <vector>
+
+#include <detail/cryptography/aes.hpp>
+
+namespace {
+
+constexpr std::size_t Segment_Size = 4096;
+
+class AesSegment : public benchmark::Fixture
+{
+public:
+    void SetUp(const ::benchmark::State &state)
+    {
+        key.assign(32, 0x2b);
+        iv.assign(16, 0x01);
+        input.resize(Segment_Size);
+        for (std::size_t i = 0; i < input.size(); ++i)
+        {
+            input[i] = static_cast<std::uint8_t>(i * 31);
+        }
+        output.resize(Segment_Size);
+        xlnt::detail::aes_allow_hardware(state.range(0) != 0);
+    }
+
+    void TearDown(const ::benchmark::State &)
+    {
+        xlnt::detail::aes_allow_hardware(true);
+    }
+
+    std::vector<std::uint8_t> key;
+    std::vector<std::uint8_t> iv;
+    std::vector<std::uint8_t> input;
+    std::vector<std::uint8_t> output;
+};
+
+// Arg(0) is the portable implementation, Arg(1) uses AES-NI if the processor has it
+void aes_args(benchmark::internal::Benchmark *benchmark)
+{
+    benchmark->Arg(0);
+    if (xlnt::detail::aes_hardware_available())
+    {
+        benchmark->Arg(1);
+    }
+}
+
+} // namespace
+
+BENCHMARK_DEFINE_F(AesSegment, ecb_decrypt)
+(benchmark::State &state)
+{
+    while (state.KeepRunning())
+    {
+        xlnt::detail::aes_ecb_decrypt(input.data(), input.size(), key, output.data());
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * Segment_Size));
+}
+BENCHMARK_REGISTER_F(AesSegment, ecb_decrypt)->Apply(aes_args);
+
+BENCHMARK_DEFINE_F(AesSegment, cbc_decrypt)
+(benchmark::State &state)
+{
+    while (state.KeepRunning())
+    {
+        xlnt::detail::aes_cbc_decrypt(input.data(), input.size(), key, iv.data(), output.data());
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * Segment_Size));
+}
+BENCHMARK_REGISTER_F(AesSegment, cbc_decrypt)->Apply(aes_args);
+
+BENCHMARK_DEFINE_F(AesSegment, ecb_encrypt)
+(benchmark::State &state)
+{
+    while (state.KeepRunning())
+    {
+        benchmark::DoNotOptimize(xlnt::detail::aes_ecb_encrypt(input, key));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * Segment_Size));
+}
+BENCHMARK_REGISTER_F(AesSegment, ecb_encrypt)->Apply(aes_args);
+
+BENCHMARK_DEFINE_F(AesSegment, cbc_encrypt)
+(benchmark::State &state)
+{
+    while (state.KeepRunning())
+    {
+        benchmark::DoNotOptimize(xlnt::detail::aes_cbc_encrypt(input, key, iv));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * Segment_Size));
+}
+BENCHMARK_REGISTER_F(AesSegment, cbc_encrypt)->Apply(aes_args);
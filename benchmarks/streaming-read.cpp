@@ -0,0 +1,84 @@
+#include <xlnt/xlnt.hpp>
+#include <chrono>
+#include <helpers/path_helper.hpp>
+
+namespace {
+using milliseconds_d = std::chrono::duration<double, std::milli>;
+using nanoseconds_d = std::chrono::duration<double, std::nano>;
+
+void report(std::chrono::steady_clock::duration elapsed, std::size_t cells)
+{
+    std::cout << milliseconds_d(elapsed).count() << " ms, "
+              << (cells > 0 ? nanoseconds_d(elapsed).count() / static_cast<double>(cells) : 0.0)
+              << " ns/cell\n";
+}
+
+void run_streaming_read_test(const xlnt::path &file, int runs = 10)
+{
+    std::cout << file.string() << " (streaming)\n\n";
+
+    for (int i = 0; i < runs; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        xlnt::streaming_workbook_reader reader;
+        reader.open(file);
+
+        std::size_t cells = 0;
+        double sum = 0.0;
+
+        for (const auto &title : reader.sheet_titles())
+        {
+            reader.begin_worksheet(title);
+
+            while (reader.has_cell())
+            {
+                auto cell = reader.read_cell();
+
+                if (cell.data_type() == xlnt::cell::type::number)
+                {
+                    sum += cell.value<double>();
+                }
+
+                ++cells;
+            }
+
+            reader.end_worksheet();
+        }
+
+        report(std::chrono::steady_clock::now() - start, cells);
+        static_cast<void>(sum);
+    }
+}
+
+void run_load_test(const xlnt::path &file, int runs = 10)
+{
+    std::cout << file.string() << " (in memory)\n\n";
+
+    for (int i = 0; i < runs; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        xlnt::workbook wb;
+        wb.load(file);
+
+        std::size_t cells = 0;
+
+        for (auto ws : wb)
+        {
+            for (auto row : ws.rows())
+            {
+                cells += row.length();
+            }
+        }
+
+        report(std::chrono::steady_clock::now() - start, cells);
+    }
+}
+} // namespace
+
+int main()
+{
+    run_streaming_read_test(path_helper::benchmark_file("large.xlsx"));
+    run_load_test(path_helper::benchmark_file("large.xlsx"));
+}
@@ -152,6 +152,8 @@ public:
     bool operator!=(const std::string &rhs) const;
 
 private:
+    friend class rich_text_hash;
+
     /// <summary>
     /// The runs that make up this rich text.
     /// </summary>
@@ -160,20 +162,21 @@ private:
     std::optional<phonetic_pr> phonetic_properties_;
 };
 
+/// <summary>
+/// Allows for use of std::unordered_set<rich_text, rich_text_hash> and similar.
+/// </summary>
 class XLNT_API rich_text_hash
 {
 public:
-    std::size_t operator()(const rich_text &k) const
-    {
-        std::size_t res = 0;
-
-        for (auto r : k.runs())
-        {
-            res ^= std::hash<std::string>()(r.first);
-        }
+    /// <summary>
+    /// Combines the text and font of every run in order.
+    /// </summary>
+    std::size_t operator()(const rich_text &k) const;
 
-        return res;
-    }
+    /// <summary>
+    /// Returns the hash of rich_text(plain_text) without constructing it.
+    /// </summary>
+    std::size_t operator()(const std::string &plain_text) const;
 };
 
 } // namespace xlnt
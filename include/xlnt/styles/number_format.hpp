@@ -25,6 +25,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 
 #include <xlnt/xlnt_config.hpp>
@@ -34,6 +35,12 @@ namespace xlnt {
 
 enum class calendar;
 
+namespace detail {
+
+struct parsed_number_format;
+
+} // namespace detail
+
 /// <summary>
 /// Describes the number formatting applied to text and numbers within a certain cell.
 /// </summary>
@@ -260,6 +267,11 @@ public:
     bool operator!=(const number_format &other) const;
 
 private:
+    /// <summary>
+    /// Returns the parsed format code, parsing it if this is its first use.
+    /// </summary>
+    const detail::parsed_number_format &parsed() const;
+
     /// <summary>
     /// The optional ID
     /// </summary>
@@ -269,6 +281,12 @@ private:
     /// The format code
     /// </summary>
     std::string format_string_;
+
+    /// <summary>
+    /// The format code once parsed, shared with copies of this format so that
+    /// formats kept in a stylesheet are only parsed once for all of their cells.
+    /// </summary>
+    std::shared_ptr<detail::parsed_number_format> parsed_;
 };
 
 } // namespace xlnt
@@ -142,12 +142,18 @@ public:
     std::string serialise(double d) const
     {
         char buf[30];
-        int len = snprintf(buf, sizeof(buf), "%.15g", d);
+        return std::string(buf, serialise(d, buf));
+    }
+
+    // as above, but writes into buf, which must hold 30 characters, and returns the length
+    size_t serialise(double d, char *buf) const
+    {
+        int len = snprintf(buf, 30, "%.15g", d);
         if (should_convert_comma)
         {
             convert_comma_to_pt(buf, len);
         }
-        return std::string(buf, static_cast<size_t>(len));
+        return static_cast<size_t>(len);
     }
 
     // replacement for std::to_string / s*printf("%f", ...)
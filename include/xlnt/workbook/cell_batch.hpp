@@ -0,0 +1,109 @@
+// Copyright (c) 2016-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <xlnt/xlnt_config.hpp>
+#include <xlnt/cell/cell_type.hpp>
+#include <xlnt/cell/index_types.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// The values of one column of a cell_batch. Every vector has one entry per
+/// row of the batch except string_offsets, which has one more.
+/// </summary>
+class XLNT_API batch_column
+{
+public:
+    /// <summary>
+    /// The type of the cell in each row, cell_type::empty where there's no cell.
+    /// </summary>
+    std::vector<cell_type> types;
+
+    /// <summary>
+    /// The value of numeric, date and boolean cells, with booleans as 0 or 1.
+    /// Zero for other rows.
+    /// </summary>
+    std::vector<double> numbers;
+
+    /// <summary>
+    /// One bit per row, least significant bit first, set where the cell has a
+    /// value. This is the layout Arrow uses for validity bitmaps.
+    /// </summary>
+    std::vector<std::uint8_t> validity;
+
+    /// <summary>
+    /// The text of the string or error cell in row i is the range
+    /// [string_offsets[i], string_offsets[i + 1]) of strings. The range is
+    /// empty for other rows.
+    /// </summary>
+    std::vector<std::uint32_t> string_offsets;
+
+    /// <summary>
+    /// The UTF-8 text of every string and error cell in the column, one after
+    /// another. Together with string_offsets and validity this is the layout
+    /// Arrow uses for string arrays.
+    /// </summary>
+    std::string strings;
+
+    /// <summary>
+    /// Returns true if the cell in the given row of the batch has a value.
+    /// </summary>
+    bool is_valid(std::size_t row) const
+    {
+        return (validity[row / 8] >> (row % 8)) & 1;
+    }
+};
+
+/// <summary>
+/// Columnar buffers filled by streaming_workbook_reader::read_batch. A batch
+/// can be passed to read_batch repeatedly, in which case its buffers are
+/// reused rather than reallocated.
+/// </summary>
+class XLNT_API cell_batch
+{
+public:
+    /// <summary>
+    /// The worksheet row number of the first row in the batch.
+    /// </summary>
+    row_t first_row = 0;
+
+    /// <summary>
+    /// The number of rows in the batch. Rows missing from the worksheet are
+    /// included as rows without any valid cells.
+    /// </summary>
+    std::size_t rows = 0;
+
+    /// <summary>
+    /// One entry per column, starting with column A.
+    /// </summary>
+    std::vector<batch_column> columns;
+};
+
+} // namespace xlnt
@@ -0,0 +1,133 @@
+// Copyright (c) 2016-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <xlnt/xlnt_config.hpp>
+#include <xlnt/worksheet/range_reference.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// Settings which control how workbook::load reads an XLSX package.
+/// The defaults match the behaviour of load overloads which don't take options.
+/// </summary>
+class XLNT_API load_options
+{
+public:
+    /// <summary>
+    /// If this is true, the cells of each worksheet are built on a second thread
+    /// while the calling thread continues to parse the remainder of the sheetData
+    /// element. This mainly helps with large worksheets.
+    /// </summary>
+    bool pipeline_sheet_data = false;
+
+    /// <summary>
+    /// The number of rows parsed before they are handed to the cell building thread
+    /// when pipeline_sheet_data is enabled. Values less than one are treated as one.
+    /// </summary>
+    std::size_t sheet_data_chunk_rows = 4096;
+
+    /// <summary>
+    /// If this is true, the rows of each worksheet are read by a scanner specialised
+    /// for the markup spreadsheet applications write inside sheetData instead of
+    /// going through the general XML parser. The decompressed worksheet is held in
+    /// memory while it's read. From the first row holding anything the scanner
+    /// doesn't recognise, the remaining rows are read by the XML parser as before.
+    /// This doesn't apply to streaming_workbook_reader.
+    /// </summary>
+    bool tokenize_sheet_data = true;
+
+    /// <summary>
+    /// The number of threads used to inflate and parse worksheets. With one thread,
+    /// worksheets are read one after another on the calling thread. Zero uses
+    /// std::thread::hardware_concurrency(). No more threads than there are
+    /// worksheets are started.
+    /// </summary>
+    std::size_t worksheet_threads = 1;
+
+    /// <summary>
+    /// If this is true, loading from a path maps the file into memory and reads
+    /// the archive straight from the mapping instead of copying it through a
+    /// std::ifstream. Files which can't be mapped are read through a stream.
+    /// The file must not be truncated by another process while it's loading.
+    /// </summary>
+    bool memory_map = true;
+
+    /// <summary>
+    /// The number of threads used to decrypt the package when loading a workbook
+    /// with a password. The package is decrypted in 4096 byte segments which are
+    /// split evenly between the threads. Zero uses std::thread::hardware_concurrency().
+    /// </summary>
+    std::size_t decryption_threads = 1;
+
+    /// <summary>
+    /// If this is true, the shared string table is only scanned for the positions
+    /// of its strings while loading, and each string is parsed the first time it's
+    /// requested, such as by reading the value of a cell which uses it. The
+    /// decompressed table is kept in memory until every string has been parsed.
+    /// Adding a shared string or using workbook::shared_strings() parses the rest.
+    /// Strings are parsed under a lock, so a const workbook can still be read from
+    /// several threads.
+    /// </summary>
+    bool lazy_shared_strings = false;
+
+    /// <summary>
+    /// The titles of the worksheets to load. If this and sheet_indices are both
+    /// empty, every worksheet is loaded. Otherwise only the worksheets named here
+    /// or in sheet_indices are added to the workbook and the parts of the others
+    /// aren't decompressed. Loading throws key_not_found if a title isn't in the workbook.
+    /// </summary>
+    std::vector<std::string> sheet_titles;
+
+    /// <summary>
+    /// The zero-based positions of the worksheets to load, see sheet_titles.
+    /// Loading throws invalid_parameter if an index isn't less than the number of worksheets.
+    /// </summary>
+    std::vector<std::size_t> sheet_indices;
+
+    /// <summary>
+    /// Bounding ranges of the cells to load, by worksheet title. Cells and row
+    /// properties outside the range of a worksheet are skipped while its sheetData
+    /// is parsed. Worksheets without a range are loaded whole.
+    /// </summary>
+    std::unordered_map<std::string, range_reference> sheet_ranges;
+
+    /// <summary>
+    /// If this is true, only cell values, formulae, shared strings and the number
+    /// formats of cells, which tell dates from numbers, are read. Fonts, fills,
+    /// borders, alignments, protections, named styles, the theme, comments,
+    /// drawings, document properties, the thumbnail and any VBA project are skipped.
+    /// Worksheet settings such as views, columns and merged cells are still read.
+    /// A workbook loaded this way isn't meant to be saved, since all of that
+    /// would be missing from it.
+    /// </summary>
+    bool values_only = false;
+};
+
+} // namespace xlnt
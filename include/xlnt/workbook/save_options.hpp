@@ -0,0 +1,57 @@
+// Copyright (c) 2016-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// Settings which control how workbook::save writes an XLSX package.
+/// The defaults match the behaviour of save overloads which don't take options.
+/// </summary>
+class XLNT_API save_options
+{
+public:
+    /// <summary>
+    /// The number of threads used to compress the parts of the package. With one
+    /// thread, each part is compressed on the calling thread while it's written.
+    /// Otherwise each part is written to its own buffer and compressed on a worker
+    /// while the next part is written, and the compressed parts are added to the
+    /// archive in their original order. Zero uses std::thread::hardware_concurrency().
+    /// </summary>
+    std::size_t compression_threads = 1;
+
+    /// <summary>
+    /// The zlib compression level of the parts of the package, from 1 (fastest)
+    /// to 9 (smallest). -1 uses the zlib default, which is 6, and 0 stores the
+    /// parts without compressing them. Other values cause save to throw
+    /// xlnt::invalid_parameter.
+    /// </summary>
+    int compression_level = -1;
+};
+
+} // namespace xlnt
@@ -23,6 +23,7 @@
 // @author: see AUTHORS file
 #pragma once
 
+#include <cstddef>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -38,11 +39,13 @@ class parser;
 namespace xlnt {
 
 class cell;
+class cell_batch;
 class path;
 class workbook;
 class worksheet;
 
 namespace detail {
+class mapped_file;
 class xlsx_consumer;
 }
 
@@ -69,6 +72,16 @@ public:
     /// </summary>
     cell read_cell();
 
+    /// <summary>
+    /// Reads up to max_rows consecutive rows of the current worksheet into batch,
+    /// keeping the first column_count columns starting from A and skipping cells
+    /// in any others. The cells are copied straight into batch's buffers without
+    /// creating a cell for each one. Returns the number of rows read, which is
+    /// zero once the end of the worksheet has been reached. Calls to read_batch
+    /// can be mixed with has_cell and read_cell.
+    /// </summary>
+    std::size_t read_batch(cell_batch &batch, std::size_t column_count, std::size_t max_rows);
+
     bool has_worksheet(const std::string &name);
 
     /// <summary>
@@ -86,7 +99,8 @@ public:
 
     /// <summary>
     /// Interprets byte vector data as an XLSX file and sets the content of this
-    /// workbook to match that file.
+    /// workbook to match that file. data is read in place, so it must not be
+    /// modified or destroyed until the reader is closed.
     /// </summary>
     void open(const std::vector<std::uint8_t> &data);
 
@@ -106,7 +120,8 @@ public:
 
     /// <summary>
     /// Interprets file with the given filename as an XLSX file and sets the
-    /// content of this workbook to match that file.
+    /// content of this workbook to match that file. The file is memory mapped
+    /// when possible and must not be truncated until the reader is closed.
     /// </summary>
     void open(const path &filename);
 
@@ -129,6 +144,14 @@ public:
 
 private:
     std::string worksheet_rel_id_;
+
+    /// <summary>
+    /// True when read_batch stopped at a cell beyond its last row, which has
+    /// been read from the worksheet but not yet returned.
+    /// </summary>
+    bool pending_cell_ = false;
+
+    std::unique_ptr<detail::mapped_file> mapping_;
     std::unique_ptr<detail::xlsx_consumer> consumer_;
     std::unique_ptr<workbook> workbook_;
     std::unique_ptr<std::istream> stream_;
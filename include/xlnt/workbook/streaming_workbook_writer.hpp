@@ -38,6 +38,7 @@ namespace xlnt {
 
 class cell;
 class cell_reference;
+class save_options;
 class worksheet;
 
 namespace detail {
@@ -45,7 +46,10 @@ class xlsx_producer;
 } // namespace detail
 
 /// <summary>
-/// workbook is the container for all other parts of the document.
+/// Writes a workbook one cell at a time in a single forward pass. Rows are
+/// compressed into the archive as they're added, so memory use doesn't grow
+/// with the number of rows; only shared strings and styles are kept until
+/// the writer is closed.
 /// </summary>
 class XLNT_API streaming_workbook_writer
 {
@@ -62,14 +66,18 @@ public:
 
     /// <summary>
     /// Writes a cell to the currently active worksheet at the position given by
-    /// ref and with the given value. ref should be to the right of or below
-    /// the previously written cell.
+    /// ref. The value and format set on the returned cell are serialized when
+    /// the next cell is added or the writer is closed, after which the cell
+    /// is no longer valid. ref must be to the right of or below the previously
+    /// written cell, otherwise xlnt::invalid_parameter is thrown. Comments and
+    /// hyperlinks aren't supported on streamed cells.
     /// </summary>
     cell add_cell(const cell_reference &ref);
 
     /// <summary>
     /// Ends writing of data to the current sheet and begins writing a new sheet
-    /// with the given title.
+    /// with the given title. Column and view properties set on the returned
+    /// worksheet are written if they're set before its first cell is added.
     /// </summary>
     worksheet add_worksheet(const std::string &title);
 
@@ -104,6 +112,27 @@ public:
     /// </summary>
     void open(std::ostream &stream);
 
+    /// <summary>
+    /// Serializes the workbook into an XLSX file and saves the bytes into
+    /// byte vector data. The compression level is taken from options, parts
+    /// are always compressed on the calling thread.
+    /// </summary>
+    void open(std::vector<std::uint8_t> &data, const save_options &options);
+
+    /// <summary>
+    /// Serializes the workbook into an XLSX file and saves the data into a file
+    /// named filename. The compression level is taken from options, parts are
+    /// always compressed on the calling thread.
+    /// </summary>
+    void open(const xlnt::path &filename, const save_options &options);
+
+    /// <summary>
+    /// Serializes the workbook into an XLSX file and saves the data into stream.
+    /// The compression level is taken from options, parts are always compressed
+    /// on the calling thread.
+    /// </summary>
+    void open(std::ostream &stream, const save_options &options);
+
     std::unique_ptr<xlnt::detail::xlsx_producer> producer_;
     std::unique_ptr<workbook> workbook_;
     std::unique_ptr<std::ostream> stream_;
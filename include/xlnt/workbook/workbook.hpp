@@ -53,6 +53,7 @@ class const_worksheet_iterator;
 class fill;
 class font;
 class format;
+class load_options;
 class rich_text;
 class manifest;
 class metadata_property;
@@ -64,7 +65,9 @@ class protection;
 class range;
 class range_reference;
 class relationship;
+class save_options;
 class streaming_workbook_reader;
+class streaming_workbook_writer;
 class style;
 class style_serializer;
 class theme;
@@ -529,6 +532,24 @@ public:
     /// </summary>
     void save(std::ostream &stream, const std::string &password) const;
 
+    /// <summary>
+    /// Serializes the workbook into an XLSX file and saves the bytes into
+    /// byte vector data. options controls how the file is written.
+    /// </summary>
+    void save(std::vector<std::uint8_t> &data, const save_options &options) const;
+
+    /// <summary>
+    /// Serializes the workbook into an XLSX file and saves the data into a file
+    /// named filename. options controls how the file is written.
+    /// </summary>
+    void save(const xlnt::path &filename, const save_options &options) const;
+
+    /// <summary>
+    /// Serializes the workbook into an XLSX file and saves the data into stream.
+    /// options controls how the file is written.
+    /// </summary>
+    void save(std::ostream &stream, const save_options &options) const;
+
     /// <summary>
     /// Interprets byte vector data as an XLSX file and sets the content of this
     /// workbook to match that file.
@@ -591,6 +612,46 @@ public:
     /// </summary>
     void load(std::istream &stream, const std::string &password);
 
+    /// <summary>
+    /// Interprets byte vector data as an XLSX file and sets the content of this
+    /// workbook to match that file. options controls how the file is read.
+    /// </summary>
+    void load(const std::vector<std::uint8_t> &data, const load_options &options);
+
+    /// <summary>
+    /// Interprets file with the given filename as an XLSX file and sets the
+    /// content of this workbook to match that file. options controls how the
+    /// file is read.
+    /// </summary>
+    void load(const xlnt::path &filename, const load_options &options);
+
+    /// <summary>
+    /// Interprets data in stream as an XLSX file and sets the content of this
+    /// workbook to match that file. options controls how the file is read.
+    /// </summary>
+    void load(std::istream &stream, const load_options &options);
+
+    /// <summary>
+    /// Interprets byte vector data as an XLSX file encrypted with the given
+    /// password and sets the content of this workbook to match that file.
+    /// options controls how the file is read.
+    /// </summary>
+    void load(const std::vector<std::uint8_t> &data, const std::string &password, const load_options &options);
+
+    /// <summary>
+    /// Interprets file with the given filename as an XLSX file encrypted with the
+    /// given password and sets the content of this workbook to match that file.
+    /// options controls how the file is read.
+    /// </summary>
+    void load(const xlnt::path &filename, const std::string &password, const load_options &options);
+
+    /// <summary>
+    /// Interprets data in stream as an XLSX file encrypted with the given password
+    /// and sets the content of this workbook to match that file. options controls
+    /// how the file is read.
+    /// </summary>
+    void load(std::istream &stream, const std::string &password, const load_options &options);
+
     // View
 
     /// <summary>
@@ -671,13 +732,15 @@ public:
 
     /// <summary>
     /// Returns the cell format at the given index. The index is the position of
-    /// the format in xl/styles.xml.
+    /// the format in xl/styles.xml. Throws invalid_parameter if there's no format
+    /// at that index.
     /// </summary>
     xlnt::format format(std::size_t format_index);
 
     /// <summary>
     /// Returns the cell format at the given index. The index is the position of
-    /// the format in xl/styles.xml.
+    /// the format in xl/styles.xml. Throws invalid_parameter if there's no format
+    /// at that index.
     /// </summary>
     const xlnt::format format(std::size_t format_index) const;
 
@@ -751,6 +814,31 @@ public:
     /// </summary>
     bool known_fonts_enabled() const;
 
+    /// <summary>
+    /// Defers the removal of unused formats, fonts, fills, borders, alignments and
+    /// protections, which otherwise runs every time a cell is moved off a format,
+    /// until the workbook is saved or garbage_collect_styles is called. This makes
+    /// restyling many cells much faster.
+    /// </summary>
+    void defer_style_garbage_collection();
+
+    /// <summary>
+    /// Collects unused style records immediately again, starting with any that
+    /// were left by a deferred collection.
+    /// </summary>
+    void resume_style_garbage_collection();
+
+    /// <summary>
+    /// Returns true if the collection of unused style records is deferred.
+    /// </summary>
+    bool style_garbage_collection_deferred() const;
+
+    /// <summary>
+    /// Removes unused formats and style records in a single pass and renumbers
+    /// the remaining ones. The indices passed to format(std::size_t) may change.
+    /// </summary>
+    void garbage_collect_styles();
+
     // Manifest
 
     /// <summary>
@@ -773,6 +861,14 @@ public:
     /// </summary>
     std::size_t add_shared_string(const rich_text &shared, bool allow_duplicates = false);
 
+    /// <summary>
+    /// Append a plain shared string, a single unformatted run of text, to the
+    /// shared string collection in this workbook. This is equivalent to
+    /// add_shared_string(rich_text(shared)) but doesn't construct a rich_text
+    /// when the string is already in the collection.
+    /// </summary>
+    std::size_t add_shared_string(const std::string &shared, bool allow_duplicates = false);
+
     /// <summary>
     /// Returns a reference to the shared string related to the specified index
     /// </summary>
@@ -858,6 +954,7 @@ public:
 
 private:
     friend class streaming_workbook_reader;
+    friend class streaming_workbook_writer;
     friend class worksheet;
     friend class detail::xlsx_consumer;
     friend class detail::xlsx_producer;
@@ -908,6 +1005,17 @@ private:
     /// </summary>
     void garbage_collect_formulae();
 
+    /// <summary>
+    /// Runs the style garbage collection that was deferred, if any, before saving.
+    /// </summary>
+    void collect_deferred_style_garbage() const;
+
+    /// <summary>
+    /// Parses the strings of a shared string table loaded with
+    /// load_options::lazy_shared_strings which haven't been parsed yet.
+    /// </summary>
+    void read_pending_shared_strings() const;
+
     /// <summary>
     /// Update extended workbook properties titlesOfParts and headingPairs when sheets change.
     /// </summary>
@@ -24,6 +24,9 @@
 
 #pragma once
 
+#include <optional>
+#include <string>
+
 #include <xlnt/xlnt_config.hpp>
 
 namespace xlnt {
@@ -62,8 +62,11 @@
 #include <xlnt/utils/variant.hpp>
 
 // workbook
+#include <xlnt/workbook/cell_batch.hpp>
 #include <xlnt/workbook/document_security.hpp>
 #include <xlnt/workbook/external_book.hpp>
+#include <xlnt/workbook/load_options.hpp>
+#include <xlnt/workbook/save_options.hpp>
 #include <xlnt/workbook/metadata_property.hpp>
 #include <xlnt/workbook/named_range.hpp>
 #include <xlnt/workbook/streaming_workbook_reader.hpp>
@@ -21,6 +21,7 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <algorithm>
 #include <exception>
 #include <arrow/api.h>
 #include <arrow/python/pyarrow.h>
@@ -167,12 +168,6 @@ void open_file(xlnt::streaming_workbook_reader &reader, pybind11::object file)
     reader.open(std::unique_ptr<std::streambuf>(new xlnt::python_streambuf(file)));
 }
 
-template<typename T>
-T cell_value(xlnt::cell cell)
-{
-    return static_cast<T>(cell.value<double>());
-}
-
 // from https://stackoverflow.com/questions/1659440/32-bit-to-16-bit-floating-point-conversion
 std::uint16_t float_to_half(float f)
 {
@@ -184,9 +179,45 @@ std::uint16_t float_to_half(float f)
     return half;
 }
 
-void append_cell_value(arrow::ArrayBuilder *builder, arrow::Type::type type, xlnt::cell cell)
+template<typename Builder, typename T>
+arrow::Status append_numbers(arrow::ArrayBuilder *builder, const xlnt::batch_column &column, std::size_t rows)
+{
+    auto typed_builder = static_cast<Builder *>(builder);
+    auto status = typed_builder->Reserve(static_cast<std::int64_t>(rows));
+
+    for (std::size_t row = 0; row < rows && status.ok(); ++row)
+    {
+        status = column.is_valid(row)
+            ? typed_builder->Append(static_cast<T>(column.numbers[row]))
+            : typed_builder->AppendNull();
+    }
+
+    return status;
+}
+
+template<typename Builder>
+arrow::Status append_strings(arrow::ArrayBuilder *builder, const xlnt::batch_column &column, std::size_t rows)
 {
-    const status = arrow::Status::OK();
+    auto typed_builder = static_cast<Builder *>(builder);
+    auto status = typed_builder->Reserve(static_cast<std::int64_t>(rows));
+
+    for (std::size_t row = 0; row < rows && status.ok(); ++row)
+    {
+        const auto begin = column.string_offsets[row];
+        const auto length = column.string_offsets[row + 1] - begin;
+
+        status = column.is_valid(row)
+            ? typed_builder->Append(column.strings.data() + begin, static_cast<std::int32_t>(length))
+            : typed_builder->AppendNull();
+    }
+
+    return status;
+}
+
+void append_column(arrow::ArrayBuilder *builder, arrow::Type::type type,
+    const xlnt::batch_column &column, std::size_t rows)
+{
+    auto status = arrow::Status::OK();
 
     switch (type)
     {
@@ -194,140 +225,114 @@ void append_cell_value(arrow::ArrayBuilder *builder, arrow::Type::type type, xln
         break;
 
     case arrow::Type::BOOL:
-        status = static_cast<arrow::BooleanBuilder *>(builder)
-            ->Append(cell.value<bool>());
+        status = append_numbers<arrow::BooleanBuilder, bool>(builder, column, rows);
         break;
 
     case arrow::Type::UINT8:
-        status = static_cast<arrow::UInt8Builder *>(builder)
-            ->Append(cell_value<std::uint8_t>(cell));
+        status = append_numbers<arrow::UInt8Builder, std::uint8_t>(builder, column, rows);
         break;
 
     case arrow::Type::INT8:
-        status = static_cast<arrow::Int8Builder *>(builder)
-          ->Append(cell_value<std::uint8_t>(cell));
+        status = append_numbers<arrow::Int8Builder, std::int8_t>(builder, column, rows);
         break;
 
     case arrow::Type::UINT16:
-        status = static_cast<arrow::UInt16Builder *>(builder)
-            ->Append(cell_value<std::uint16_t>(cell));
+        status = append_numbers<arrow::UInt16Builder, std::uint16_t>(builder, column, rows);
         break;
 
     case arrow::Type::INT16:
-        status = static_cast<arrow::Int16Builder *>(builder)
-            ->Append(cell_value<std::int16_t>(cell));
+        status = append_numbers<arrow::Int16Builder, std::int16_t>(builder, column, rows);
         break;
 
     case arrow::Type::UINT32:
-        status = static_cast<arrow::UInt32Builder *>(builder)
-            ->Append(cell_value<std::uint32_t>(cell));
+        status = append_numbers<arrow::UInt32Builder, std::uint32_t>(builder, column, rows);
         break;
 
     case arrow::Type::INT32:
-        status = static_cast<arrow::Int32Builder *>(builder)
-            ->Append(cell_value<std::int32_t>(cell));
+        status = append_numbers<arrow::Int32Builder, std::int32_t>(builder, column, rows);
         break;
 
     case arrow::Type::UINT64:
-        status = static_cast<arrow::UInt64Builder *>(builder)
-            ->Append(cell_value<std::uint64_t>(cell));
+        status = append_numbers<arrow::UInt64Builder, std::uint64_t>(builder, column, rows);
         break;
 
     case arrow::Type::INT64:
-        status = static_cast<arrow::Int64Builder *>(builder)
-            ->Append(cell_value<std::int64_t>(cell));
+        status = append_numbers<arrow::Int64Builder, std::int64_t>(builder, column, rows);
         break;
 
     case arrow::Type::HALF_FLOAT:
-        status = static_cast<arrow::HalfFloatBuilder *>(builder)
-            ->Append(float_to_half(cell_value<float>(cell)));
+    {
+        auto half_builder = static_cast<arrow::HalfFloatBuilder *>(builder);
+
+        for (std::size_t row = 0; row < rows && status.ok(); ++row)
+        {
+            status = column.is_valid(row)
+                ? half_builder->Append(float_to_half(static_cast<float>(column.numbers[row])))
+                : half_builder->AppendNull();
+        }
+
         break;
+    }
 
     case arrow::Type::FLOAT:
-        status = static_cast<arrow::FloatBuilder *>(builder)
-            ->Append(cell_value<float>(cell));
+        status = append_numbers<arrow::FloatBuilder, float>(builder, column, rows);
         break;
 
     case arrow::Type::DOUBLE:
-        status = static_cast<arrow::DoubleBuilder *>(builder)
-            ->Append(cell_value<double>(cell));
+        status = append_numbers<arrow::DoubleBuilder, double>(builder, column, rows);
         break;
 
     case arrow::Type::STRING:
-        status = static_cast<arrow::StringBuilder *>(builder)
-            ->Append(cell.value<std::string>());
+        status = append_strings<arrow::StringBuilder>(builder, column, rows);
         break;
 
     case arrow::Type::BINARY:
-        status = static_cast<arrow::BinaryBuilder *>(builder)
-            ->Append(cell.value<std::string>());
+        status = append_strings<arrow::BinaryBuilder>(builder, column, rows);
         break;
 
     case arrow::Type::FIXED_SIZE_BINARY:
-        status = static_cast<arrow::FixedSizeBinaryBuilder *>(builder)
-            ->Append(cell.value<std::string>());
+    {
+        // values are appended whole, the builder's byte width decides how much is read
+        auto fixed_builder = static_cast<arrow::FixedSizeBinaryBuilder *>(builder);
+
+        for (std::size_t row = 0; row < rows && status.ok(); ++row)
+        {
+            const auto begin = column.string_offsets[row];
+            const auto end = column.string_offsets[row + 1];
+
+            status = column.is_valid(row)
+                ? fixed_builder->Append(std::string(column.strings.data() + begin, end - begin))
+                : fixed_builder->AppendNull();
+        }
+
         break;
+    }
 
     case arrow::Type::DATE32:
-        status = static_cast<arrow::Date32Builder *>(builder)
-            ->Append(cell_value<arrow::Date32Type::c_type>(cell));
+        status = append_numbers<arrow::Date32Builder, arrow::Date32Type::c_type>(builder, column, rows);
         break;
 
     case arrow::Type::DATE64:
-        status = static_cast<arrow::Date64Builder *>(builder)
-            ->Append(cell_value<arrow::Date64Type::c_type>(cell));
+        status = append_numbers<arrow::Date64Builder, arrow::Date64Type::c_type>(builder, column, rows);
         break;
 
     case arrow::Type::TIMESTAMP:
-        status = static_cast<arrow::TimestampBuilder *>(builder)
-            ->Append(cell_value<arrow::TimestampType::c_type>(cell));
+        status = append_numbers<arrow::TimestampBuilder, arrow::TimestampType::c_type>(builder, column, rows);
         break;
 
     case arrow::Type::TIME32:
-        status = static_cast<arrow::Time32Builder *>(builder)
-            ->Append(cell_value<arrow::Time32Type::c_type>(cell));
+        status = append_numbers<arrow::Time32Builder, arrow::Time32Type::c_type>(builder, column, rows);
         break;
 
     case arrow::Type::TIME64:
-        status = static_cast<arrow::Time64Builder *>(builder)
-            ->Append(cell_value<arrow::Time64Type::c_type>(cell));
-        break;
-/*
-    case arrow::Type::INTERVAL:
-        status = static_cast<arrow::IntervalBuilder *>(builder)
-            ->Append(cell_value<std::int64_t>(cell));
-        break;
-
-    case arrow::Type::DECIMAL:
-        status = static_cast<arrow::DecimalBuilder *>(builder)
-            ->Append(cell.value<std::string>());
+        status = append_numbers<arrow::Time64Builder, arrow::Time64Type::c_type>(builder, column, rows);
         break;
 
-    case arrow::Type::LIST:
-        status = static_cast<arrow::ListBuilder *>(builder)
-            ->Append(cell.value<std::string>());
-        break;
-
-    case arrow::Type::STRUCT:
-        status = static_cast<arrow::StructBuilder *>(builder)
-            ->Append(cell.value<std::string>());
-        break;
-
-    case arrow::Type::UNION:
-        status = static_cast<arrow::UnionBuilder *>(builder)
-            ->Append(cell.value<std::string>());
-        break;
-
-    case arrow::Type::DICTIONARY:
-        status = static_cast<arrow::DictionaryBuilder *>(builder)
-            ->Append(cell.value<std::string>());
-        break;
-*/
     default:
         throw xlnt::exception("not implemented");
     }
 
-    if (status != arrow::Status::OK())
+    if (!status.ok())
     {
         throw xlnt::exception("Append failed");
     }
@@ -355,25 +360,14 @@ pybind11::handle read_batch(xlnt::streaming_workbook_reader &reader,
         builders.emplace_back(make_array_builder(type));
     }
 
-    auto row = std::int64_t(0);
+    // the cells of the batch are read into columnar buffers in one call
+    // rather than through a cell handle each
+    xlnt::cell_batch batch;
+    const auto rows = reader.read_batch(batch, column_types.size(), static_cast<std::size_t>(std::max(max_rows, 0)));
 
-    while (row < max_rows)
+    for (std::size_t column = 0; column < column_types.size(); ++column)
     {
-        if (!reader.has_cell()) break;
-
-        for (auto column = 0; column < schema->num_fields(); ++column)
-        {
-            if (!reader.has_cell()) break;
-
-            auto cell = reader.read_cell();
-            auto zero_indexed_column = cell.column().index - 1;
-            auto column_type = column_types.at(zero_indexed_column);
-            auto builder = builders.at(zero_indexed_column).get();
-
-            append_cell_value(builder, column_type, cell);
-        }
-
-        ++row;
+        append_column(builders[column].get(), column_types[column], batch.columns[column], rows);
     }
 
     auto columns = std::vector<std::shared_ptr<arrow::Array>>();
@@ -385,7 +379,7 @@ pybind11::handle read_batch(xlnt::streaming_workbook_reader &reader,
         columns.emplace_back(column);
     }
 
-    auto batch_pointer = std::make_shared<arrow::RecordBatch>(schema, row, columns);
+    auto batch_pointer = std::make_shared<arrow::RecordBatch>(schema, static_cast<std::int64_t>(rows), columns);
     auto batch_object = arrow::py::wrap_record_batch(batch_pointer);
     auto batch_handle = pybind11::handle(batch_object); // don't need to incr. reference count, right?
 
@@ -52,29 +52,32 @@ def xlsx2arrow(io, sheetname):
     first_batch = []
     max_column = 0
 
-    while reader.has_cell():
-        if schema is None:
-            cell = reader.read_cell()
-            type = cell.data_type()
+    while schema is None and reader.has_cell():
+        cell = reader.read_cell()
+        type = cell.data_type()
 
-            if cell.row() == 1:
-                column_names.append(cell.value_string())
-                max_column = max(max_column, cell.column())
-                continue
-            elif cell.row() == 2:
-                column_name = column_names[cell.column() - 1]
-                if type == xpa.Cell.Type.Number and cell.format_is_date():
-                    fields.append(pa.field(column_name, pa.date32))
-                else:
-                    fields.append(pa.field(column_name, COLUMN_TYPE_FIELD[type]()))
-                first_batch.append(cell_to_pyarrow_array(cell, fields[-1].type))
-                if cell.column() == max_column:
-                    schema = pa.schema(fields)
-                    print(schema)
-                    batches.append(pa.RecordBatch.from_arrays(first_batch, column_names))
-                continue
+        if cell.row() == 1:
+            column_names.append(cell.value_string())
+            max_column = max(max_column, cell.column())
+        elif cell.row() == 2:
+            column_name = column_names[cell.column() - 1]
+            if type == xpa.Cell.Type.Number and cell.format_is_date():
+                fields.append(pa.field(column_name, pa.date32))
+            else:
+                fields.append(pa.field(column_name, COLUMN_TYPE_FIELD[type]()))
+            first_batch.append(cell_to_pyarrow_array(cell, fields[-1].type))
+            if cell.column() == max_column:
+                schema = pa.schema(fields)
+                print(schema)
+                batches.append(pa.RecordBatch.from_arrays(first_batch, column_names))
 
-        batches.append(reader.read_batch(schema, 10000))
+    # read_batch reads the remaining rows itself, so has_cell mustn't be
+    # called between batches or the first cell of each would be skipped
+    while schema is not None:
+        batch = reader.read_batch(schema, 10000)
+        if batch.num_rows == 0:
+            break
+        batches.append(batch)
 
     reader.end_worksheet()
 
@@ -61,6 +61,18 @@
 
 namespace {
 
+// Retypes through the owning store so that its shared string count stays correct.
+void set_type(xlnt::detail::cell_impl &impl, xlnt::cell_type type)
+{
+    if (impl.parent_ == nullptr)
+    {
+        impl.type_ = type;
+        return;
+    }
+
+    impl.parent_->cell_map_.set_type(impl, type);
+}
+
 std::pair<bool, double> cast_numeric(const std::string &s)
 {
     xlnt::detail::number_serialiser ser;
@@ -208,56 +220,59 @@ void cell::value(std::nullptr_t)
 
 void cell::value(bool boolean_value)
 {
-    d_->type_ = type::boolean;
+    set_type(*d_, type::boolean);
     d_->value_numeric_ = boolean_value ? 1.0 : 0.0;
 }
 
 void cell::value(int int_value)
 {
     d_->value_numeric_ = static_cast<double>(int_value);
-    d_->type_ = type::number;
+    set_type(*d_, type::number);
 }
 
 void cell::value(unsigned int int_value)
 {
     d_->value_numeric_ = static_cast<double>(int_value);
-    d_->type_ = type::number;
+    set_type(*d_, type::number);
 }
 
 void cell::value(long long int int_value)
 {
     d_->value_numeric_ = static_cast<double>(int_value);
-    d_->type_ = type::number;
+    set_type(*d_, type::number);
 }
 
 void cell::value(unsigned long long int int_value)
 {
     d_->value_numeric_ = static_cast<double>(int_value);
-    d_->type_ = type::number;
+    set_type(*d_, type::number);
 }
 
 void cell::value(float float_value)
 {
     d_->value_numeric_ = static_cast<double>(float_value);
-    d_->type_ = type::number;
+    set_type(*d_, type::number);
 }
 
 void cell::value(double float_value)
 {
     d_->value_numeric_ = static_cast<double>(float_value);
-    d_->type_ = type::number;
+    set_type(*d_, type::number);
 }
 
 void cell::value(const std::string &s)
 {
-    value(rich_text(check_string(s)));
+    const auto index = workbook().add_shared_string(check_string(s));
+
+    set_type(*d_, type::shared_string);
+    d_->value_numeric_ = static_cast<double>(index);
 }
 
 void cell::value(const rich_text &text)
 {
     check_string(text.plain_text());
 
-    d_->type_ = type::shared_string;
+    set_type(*d_, type::shared_string);
     d_->value_numeric_ = static_cast<double>(workbook().add_shared_string(text));
 }
 
@@ -268,38 +283,38 @@ void cell::value(const char *c)
 
 void cell::value(const cell& c)
 {
-    d_->type_ = c.d_->type_;
+    set_type(*d_, c.d_->type_);
     d_->value_numeric_ = c.d_->value_numeric_;
-    d_->value_text_ = c.d_->value_text_;
-    d_->hyperlink_ = c.d_->hyperlink_;
-    d_->formula_ = c.d_->formula_;
+    d_->value_text(c.d_->value_text());
+    d_->hyperlink(c.d_->hyperlink());
+    d_->formula(c.d_->formula());
     d_->format_ = c.d_->format_;
 }
 
 void cell::value(const date &d)
 {
-    d_->type_ = type::number;
+    set_type(*d_, type::number);
     d_->value_numeric_ = d.to_number(base_date());
     number_format(number_format::date_yyyymmdd2());
 }
 
 void cell::value(const datetime &d)
 {
-    d_->type_ = type::number;
+    set_type(*d_, type::number);
     d_->value_numeric_ = d.to_number(base_date());
     number_format(number_format::date_datetime());
 }
 
 void cell::value(const time &t)
 {
-    d_->type_ = type::number;
+    set_type(*d_, type::number);
     d_->value_numeric_ = t.to_number();
     number_format(number_format::date_time6());
 }
 
 void cell::value(const timedelta &t)
 {
-    d_->type_ = type::number;
+    set_type(*d_, type::number);
     d_->value_numeric_ = t.to_number();
     number_format(xlnt::number_format("[hh]:mm:ss"));
 }
@@ -365,7 +380,7 @@ cell &cell::operator=(const cell &rhs) = default;
 
 hyperlink cell::hyperlink() const
 {
-    return xlnt::hyperlink(d_->hyperlink_.get());
+    return xlnt::hyperlink(d_->hyperlink().get());
 }
 
 void cell::hyperlink(const std::string &url, const std::string &display)
@@ -378,7 +393,8 @@ void cell::hyperlink(const std::string &url, const std::string &display)
     auto ws = worksheet();
     auto &manifest = ws.workbook().manifest();
 
-    d_->hyperlink_ = std::make_shared<detail::hyperlink_impl>();
+    auto link = std::make_shared<detail::hyperlink_impl>();
+    d_->hyperlink(link);
 
     // check for existing relationships
     auto relationships = manifest.relationships(ws.path(), relationship_type::hyperlink);
@@ -386,7 +402,7 @@ void cell::hyperlink(const std::string &url, const std::string &display)
         [&url](xlnt::relationship rel) { return rel.target().path().string() == url; });
     if (relation != relationships.end())
     {
-        d_->hyperlink_->relationship = *relation;
+        link->relationship = *relation;
     }
     else
     { // register a new relationship
@@ -396,16 +412,16 @@ void cell::hyperlink(const std::string &url, const std::string &display)
             uri(url),
             target_mode::external);
         // TODO: make manifest::register_relationship return the created relationship instead of rel id
-        d_->hyperlink_->relationship = manifest.relationship(ws.path(), rel_id);
+        link->relationship = manifest.relationship(ws.path(), rel_id);
     }
     // if a value is already present, the display string is ignored
     if (has_value())
     {
-        d_->hyperlink_->display.emplace(to_string());
+        link->display.emplace(to_string());
     }
     else
     {
-        d_->hyperlink_->display.emplace(display.empty() ? url : display);
+        link->display.emplace(display.empty() ? url : display);
         value(hyperlink().display());
     }
 }
@@ -415,17 +431,18 @@ void cell::hyperlink(xlnt::cell target, const std::string &display)
     // TODO: should this computed value be a method on a cell?
     const auto cell_address = target.worksheet().title() + "!" + target.reference().to_string();
 
-    d_->hyperlink_ = std::make_shared<detail::hyperlink_impl>();
-    d_->hyperlink_->relationship = xlnt::relationship("", relationship_type::hyperlink,
+    auto link = std::make_shared<detail::hyperlink_impl>();
+    d_->hyperlink(link);
+    link->relationship = xlnt::relationship("", relationship_type::hyperlink,
         uri(""), uri(cell_address), target_mode::internal);
     // if a value is already present, the display string is ignored
     if (has_value())
     {
-        d_->hyperlink_->display.emplace(to_string());
+        link->display.emplace(to_string());
     }
     else
     {
-        d_->hyperlink_->display.emplace(display.empty() ? cell_address : display);
+        link->display.emplace(display.empty() ? cell_address : display);
         value(hyperlink().display());
     }
 }
@@ -435,18 +452,19 @@ void cell::hyperlink(xlnt::range target, const std::string &display)
     // TODO: should this computed value be a method on a cell?
     const auto range_address = target.target_worksheet().title() + "!" + target.reference().to_string();
 
-    d_->hyperlink_ = std::make_shared<detail::hyperlink_impl>();
-    d_->hyperlink_->relationship = xlnt::relationship("", relationship_type::hyperlink,
+    auto link = std::make_shared<detail::hyperlink_impl>();
+    d_->hyperlink(link);
+    link->relationship = xlnt::relationship("", relationship_type::hyperlink,
         uri(""), uri(range_address), target_mode::internal);
 
     // if a value is already present, the display string is ignored
     if (has_value())
     {
-        d_->hyperlink_->display.emplace(to_string());
+        link->display.emplace(to_string());
     }
     else
     {
-        d_->hyperlink_->display.emplace(display.empty() ? range_address : display);
+        link->display.emplace(display.empty() ? range_address : display);
         value(hyperlink().display());
     }
 }
@@ -460,11 +478,11 @@ void cell::formula(const std::string &formula)
 
     if (formula[0] == '=')
     {
-        d_->formula_ = formula.substr(1);
+        d_->formula(formula.substr(1));
     }
     else
     {
-        d_->formula_ = formula;
+        d_->formula(formula);
     }
 
     worksheet().register_calc_chain_in_manifest();
@@ -472,19 +490,19 @@ void cell::formula(const std::string &formula)
 
 bool cell::has_formula() const
 {
-    return d_->formula_.has_value();
+    return d_->formula().has_value();
 }
 
 std::string cell::formula() const
 {
-    return d_->formula_.value();
+    return d_->formula().value();
 }
 
 void cell::clear_formula()
 {
     if (has_formula())
     {
-        d_->formula_ = nullptr;
+        d_->formula(std::nullopt);
         worksheet().garbage_collect_formulae();
     }
 }
@@ -505,8 +523,8 @@ void cell::error(const std::string &error)
         throw invalid_data_type();
     }
 
-    d_->value_text_->plain_text(error, false);
-    d_->type_ = type::error;
+    d_->value_text(std::make_shared<rich_text>(error));
+    set_type(*d_, type::error);
 }
 
 cell cell::offset(int column, int row)
@@ -560,12 +578,13 @@ cell::type cell::data_type() const
 
 void cell::data_type(type t)
 {
-    d_->type_ = t;
+    set_type(*d_, t);
 }
 
 number_format cell::computed_number_format() const
 {
-    return xlnt::number_format();
+    // a copy of the builtin format, which is only parsed once
+    return xlnt::number_format::general();
 }
 
 font cell::computed_font() const
@@ -596,8 +615,8 @@ protection cell::computed_protection() const
 void cell::clear_value()
 {
     d_->value_numeric_ = 0;
-    d_->value_text_ = nullptr;
-    d_->type_ = cell::type::empty;
+    d_->value_text(nullptr);
+    set_type(*d_, cell::type::empty);
     clear_formula();
 }
 
@@ -717,7 +736,7 @@ XLNT_API rich_text cell::value() const
         return workbook().shared_strings(static_cast<std::size_t>(d_->value_numeric_));
     }
 
-    return *d_->value_text_;
+    return d_->value_text() ? *d_->value_text() : rich_text();
 }
 
 bool cell::has_value() const
@@ -810,7 +829,7 @@ void cell::value(const std::string &value_string, bool infer_type)
     if (percentage.first)
     {
         d_->value_numeric_ = percentage.second;
-        d_->type_ = cell::type::number;
+        set_type(*d_, cell::type::number);
         number_format(xlnt::number_format::percentage());
     }
     else
@@ -819,7 +838,7 @@ void cell::value(const std::string &value_string, bool infer_type)
 
         if (time.first)
         {
-            d_->type_ = cell::type::number;
+            set_type(*d_, cell::type::number);
             number_format(number_format::date_time6());
             d_->value_numeric_ = time.second.to_number();
         }
@@ -830,7 +849,7 @@ void cell::value(const std::string &value_string, bool infer_type)
             if (numeric.first)
             {
                 d_->value_numeric_ = numeric.second;
-                d_->type_ = cell::type::number;
+                set_type(*d_, cell::type::number);
             }
         }
     }
@@ -949,14 +968,14 @@ protection cell::protection() const
 
 bool cell::has_hyperlink() const
 {
-    return d_->hyperlink_ != nullptr;
+    return d_->hyperlink() != nullptr;
 }
 
 // comment
 
 bool cell::has_comment()
 {
-    return d_->comment_ != nullptr;
+    return d_->comment_ptr() != nullptr;
 }
 
 void cell::clear_comment()
@@ -964,7 +983,7 @@ void cell::clear_comment()
     if (has_comment())
     {
         d_->parent_->comments_.erase(reference().to_string());
-        d_->comment_ = nullptr;
+        d_->comment_ptr(nullptr);
     }
 }
 
@@ -975,7 +994,7 @@ class comment cell::comment()
         throw xlnt::exception("cell has no comment");
     }
 
-    return *d_->comment_;
+    return *d_->comment_ptr();
 }
 
 void cell::comment(const std::string &text, const std::string &author)
@@ -992,12 +1011,12 @@ void cell::comment(const class comment &new_comment)
 {
     if (has_comment())
     {
-        *d_->comment_ = new_comment;
+        *d_->comment_ptr() = new_comment;
     }
     else
     {
         d_->parent_->comments_[reference().to_string()] = new_comment;
-        d_->comment_ = &d_->parent_->comments_[reference().to_string()];
+        d_->comment_ptr(&d_->parent_->comments_[reference().to_string()]);
     }
 
     // offset comment 5 pixels down and 5 pixels right of the top right corner of the cell
@@ -1005,7 +1024,7 @@ void cell::comment(const class comment &new_comment)
     cell_position.first += static_cast<int>(width()) + 5;
     cell_position.second += 5;
 
-    d_->comment_->position(cell_position.first, cell_position.second);
+    d_->comment_ptr()->position(cell_position.first, cell_position.second);
 
     worksheet().register_comments_in_manifest();
 }
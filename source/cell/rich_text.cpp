@@ -21,8 +21,10 @@
 //
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
+#include <functional>
 #include <numeric>
 
+#include <detail/implementations/style_hash.hpp>
 #include <xlnt/cell/rich_text.hpp>
 #include <xlnt/cell/rich_text_run.hpp>
 
@@ -31,6 +33,16 @@ bool has_trailing_whitespace(const std::string &s)
 {
     return !s.empty() && (s.front() == ' ' || s.back() == ' ');
 };
+
+void hash_run(std::size_t &seed, const std::string &text, const std::optional<xlnt::font> &font)
+{
+    const auto font_hash = font.has_value() ? xlnt::detail::style_hash()(font.value()) + 1 : 0;
+
+    for (auto value : {std::hash<std::string>()(text), font_hash})
+    {
+        seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+}
 } // namespace
 
 namespace xlnt {
@@ -156,7 +168,8 @@ bool rich_text::operator==(const rich_text &rhs) const
 
 bool rich_text::operator==(const std::string &rhs) const
 {
-    return *this == rich_text(rhs);
+    return runs_.size() == 1 && !runs_.front().second.has_value() && runs_.front().first == rhs
+        && phonetic_runs_.empty() && !phonetic_properties_.has_value();
 }
 
 bool rich_text::operator!=(const rich_text &rhs) const
@@ -169,4 +182,24 @@ bool rich_text::operator!=(const std::string &rhs) const
     return !(*this == rhs);
 }
 
+std::size_t rich_text_hash::operator()(const rich_text &k) const
+{
+    std::size_t seed = k.runs_.size();
+
+    for (const auto &run : k.runs_)
+    {
+        hash_run(seed, run.first, run.second);
+    }
+
+    return seed;
+}
+
+std::size_t rich_text_hash::operator()(const std::string &plain_text) const
+{
+    std::size_t seed = 1;
+    hash_run(seed, plain_text, std::optional<font>());
+
+    return seed;
+}
+
 } // namespace xlnt
@@ -28,12 +28,27 @@
 #include <algorithm>
 #include <array>
 #include <assert.h>
+#include <atomic>
 #include <stdio.h>
 #include <stdlib.h>
 
 #include <xlnt/utils/exceptions.hpp>
 #include <detail/cryptography/aes.hpp>
 
+// AES-NI kernels are compiled for x86 with per-function target attributes and
+// only used when cpuid reports support, so the library runs on any x86 processor.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define XLNT_AES_NI
+#include <wmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define XLNT_AES_NI_TARGET
+#else
+#include <cpuid.h>
+#define XLNT_AES_NI_TARGET __attribute__((target("aes,sse2")))
+#endif
+#endif
+
 namespace {
 
 static const std::uint32_t TE0[256] = {
@@ -2973,6 +2988,196 @@ void rijndael_ecb_decrypt(const unsigned char *ct, unsigned char *pt, rijndael_k
 #undef STORE32H
 #undef RORc
 
+std::atomic<bool> hardware_allowed(true);
+
+bool cpu_supports_aes_ni()
+{
+#ifdef XLNT_AES_NI
+#ifdef _MSC_VER
+    int registers[4];
+    __cpuid(registers, 1);
+    const auto ecx = static_cast<unsigned int>(registers[2]);
+    const auto edx = static_cast<unsigned int>(registers[3]);
+#else
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+#endif
+    return (ecx & (1u << 25)) != 0 // AES
+        && (edx & (1u << 26)) != 0; // SSE2
+#else
+    return false;
+#endif
+}
+
+bool use_aes_ni()
+{
+    return xlnt::detail::aes_hardware_available() && hardware_allowed.load(std::memory_order_relaxed);
+}
+
+#ifdef XLNT_AES_NI
+
+// The portable key schedule keeps each round key as four big-endian words.
+// Written out as bytes they are the round keys AES-NI expects, and dK is
+// already the schedule of the equivalent inverse cipher used by aesdec.
+XLNT_AES_NI_TARGET void load_round_keys(const std::uint32_t *words, int rounds, __m128i *round_keys)
+{
+    for (auto round = 0; round <= rounds; ++round)
+    {
+        alignas(16) std::uint8_t bytes[16];
+
+        for (auto i = 0; i < 16; ++i)
+        {
+            bytes[i] = static_cast<std::uint8_t>(words[4 * round + i / 4] >> (24 - 8 * (i % 4)));
+        }
+
+        round_keys[round] = _mm_load_si128(reinterpret_cast<const __m128i *>(bytes));
+    }
+}
+
+XLNT_AES_NI_TARGET __m128i aes_ni_encrypt_block(__m128i block, const __m128i *round_keys, int rounds)
+{
+    block = _mm_xor_si128(block, round_keys[0]);
+
+    for (auto round = 1; round < rounds; ++round)
+    {
+        block = _mm_aesenc_si128(block, round_keys[round]);
+    }
+
+    return _mm_aesenclast_si128(block, round_keys[rounds]);
+}
+
+// Decrypts four independent blocks at once so that the aesdec latency is hidden.
+XLNT_AES_NI_TARGET void aes_ni_decrypt_blocks(__m128i *blocks, const __m128i *round_keys, int rounds)
+{
+    for (auto i = 0; i < 4; ++i)
+    {
+        blocks[i] = _mm_xor_si128(blocks[i], round_keys[0]);
+    }
+
+    for (auto round = 1; round < rounds; ++round)
+    {
+        for (auto i = 0; i < 4; ++i)
+        {
+            blocks[i] = _mm_aesdec_si128(blocks[i], round_keys[round]);
+        }
+    }
+
+    for (auto i = 0; i < 4; ++i)
+    {
+        blocks[i] = _mm_aesdeclast_si128(blocks[i], round_keys[rounds]);
+    }
+}
+
+XLNT_AES_NI_TARGET __m128i aes_ni_decrypt_block(__m128i block, const __m128i *round_keys, int rounds)
+{
+    block = _mm_xor_si128(block, round_keys[0]);
+
+    for (auto round = 1; round < rounds; ++round)
+    {
+        block = _mm_aesdec_si128(block, round_keys[round]);
+    }
+
+    return _mm_aesdeclast_si128(block, round_keys[rounds]);
+}
+
+XLNT_AES_NI_TARGET void aes_ni_ecb_encrypt(const std::uint8_t *pt, std::uint8_t *ct, std::size_t len,
+    const rijndael_key &skey)
+{
+    __m128i round_keys[15];
+    load_round_keys(skey.eK, skey.Nr, round_keys);
+
+    for (; len; pt += 16, ct += 16, len -= 16)
+    {
+        const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pt));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(ct), aes_ni_encrypt_block(block, round_keys, skey.Nr));
+    }
+}
+
+XLNT_AES_NI_TARGET void aes_ni_ecb_decrypt(const std::uint8_t *ct, std::uint8_t *pt, std::size_t len,
+    const rijndael_key &skey)
+{
+    __m128i round_keys[15];
+    load_round_keys(skey.dK, skey.Nr, round_keys);
+
+    for (; len >= 64; ct += 64, pt += 64, len -= 64)
+    {
+        __m128i blocks[4];
+
+        for (auto i = 0; i < 4; ++i)
+        {
+            blocks[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ct) + i);
+        }
+
+        aes_ni_decrypt_blocks(blocks, round_keys, skey.Nr);
+
+        for (auto i = 0; i < 4; ++i)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(pt) + i, blocks[i]);
+        }
+    }
+
+    for (; len; ct += 16, pt += 16, len -= 16)
+    {
+        const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ct));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(pt), aes_ni_decrypt_block(block, round_keys, skey.Nr));
+    }
+}
+
+XLNT_AES_NI_TARGET void aes_ni_cbc_encrypt(const std::uint8_t *pt, std::uint8_t *ct, std::size_t len,
+    const std::uint8_t *iv, const rijndael_key &skey)
+{
+    __m128i round_keys[15];
+    load_round_keys(skey.eK, skey.Nr, round_keys);
+
+    // each block depends on the previous ciphertext, so CBC encryption is serial
+    auto chain = _mm_loadu_si128(reinterpret_cast<const __m128i *>(iv));
+
+    for (; len; pt += 16, ct += 16, len -= 16)
+    {
+        const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pt));
+        chain = aes_ni_encrypt_block(_mm_xor_si128(block, chain), round_keys, skey.Nr);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(ct), chain);
+    }
+}
+
+XLNT_AES_NI_TARGET void aes_ni_cbc_decrypt(const std::uint8_t *ct, std::uint8_t *pt, std::size_t len,
+    const std::uint8_t *iv, const rijndael_key &skey)
+{
+    __m128i round_keys[15];
+    load_round_keys(skey.dK, skey.Nr, round_keys);
+
+    auto chain = _mm_loadu_si128(reinterpret_cast<const __m128i *>(iv));
+
+    for (; len >= 64; ct += 64, pt += 64, len -= 64)
+    {
+        __m128i ciphertext[4];
+        __m128i blocks[4];
+
+        for (auto i = 0; i < 4; ++i)
+        {
+            blocks[i] = ciphertext[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ct) + i);
+        }
+
+        aes_ni_decrypt_blocks(blocks, round_keys, skey.Nr);
+
+        for (auto i = 0; i < 4; ++i)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(pt) + i, _mm_xor_si128(blocks[i], chain));
+            chain = ciphertext[i];
+        }
+    }
+
+    for (; len; ct += 16, pt += 16, len -= 16)
+    {
+        const auto ciphertext = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ct));
+        const auto block = aes_ni_decrypt_block(ciphertext, round_keys, skey.Nr);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(pt), _mm_xor_si128(block, chain));
+        chain = ciphertext;
+    }
+}
+
+#endif // XLNT_AES_NI
+
 } // namespace
 
 namespace xlnt {
@@ -2999,6 +3204,14 @@ std::vector<std::uint8_t> aes_ecb_encrypt(
     auto pt = plaintext.data() + offset;
     auto ct = ciphertext.data();
 
+#ifdef XLNT_AES_NI
+    if (use_aes_ni())
+    {
+        aes_ni_ecb_encrypt(pt, ct, len, expanded_key);
+        return ciphertext;
+    }
+#endif
+
     while (len)
     {
         rijndael_ecb_encrypt(pt, ct, expanded_key);
@@ -3028,9 +3241,37 @@ std::vector<std::uint8_t> aes_ecb_decrypt(
     }
 
     auto plaintext = std::vector<std::uint8_t>(len);
+    aes_ecb_decrypt(ciphertext.data() + offset, len, key, plaintext.data());
+
+    return plaintext;
+}
+
+void aes_ecb_decrypt(
+    const std::uint8_t *ciphertext,
+    std::size_t len,
+    const std::vector<std::uint8_t> &key,
+    std::uint8_t *plaintext)
+{
+    if (len % 16 != 0)
+    {
+        throw xlnt::exception("Invalid ECB ciphertext length ("
+            + std::to_string(len)
+            + " bytes). Must be a multiple of 16 bytes.");
+    }
+
+    if (len == 0) return;
+
     auto expanded_key = rijndael_setup(key);
-    auto ct = ciphertext.data() + offset;
-    auto pt = plaintext.data();
+    auto ct = ciphertext;
+    auto pt = plaintext;
+
+#ifdef XLNT_AES_NI
+    if (use_aes_ni())
+    {
+        aes_ni_ecb_decrypt(ct, pt, len, expanded_key);
+        return;
+    }
+#endif
 
     while (len)
     {
@@ -3040,8 +3281,6 @@ std::vector<std::uint8_t> aes_ecb_decrypt(
         ct += 16;
         len -= 16;
     }
-
-    return plaintext;
 }
 
 std::vector<std::uint8_t> aes_cbc_encrypt(
@@ -3068,6 +3307,14 @@ std::vector<std::uint8_t> aes_cbc_encrypt(
     auto iv_vec = original_iv;
     auto iv = iv_vec.data();
 
+#ifdef XLNT_AES_NI
+    if (use_aes_ni())
+    {
+        aes_ni_cbc_encrypt(pt, ct, len, iv, expanded_key);
+        return ciphertext;
+    }
+#endif
+
     while (len)
     {
         for (auto x = 0; x < 16; x++)
@@ -3107,14 +3354,44 @@ std::vector<std::uint8_t> aes_cbc_decrypt(
             + " bytes). Must be a multiple of 16 bytes.");
     }
 
+    auto plaintext = std::vector<std::uint8_t>(len);
+    aes_cbc_decrypt(ciphertext.data() + offset, len, key, original_iv.data(), plaintext.data());
+
+    return plaintext;
+}
+
+void aes_cbc_decrypt(
+    const std::uint8_t *ciphertext,
+    std::size_t len,
+    const std::vector<std::uint8_t> &key,
+    const std::uint8_t *original_iv,
+    std::uint8_t *plaintext)
+{
+    if (len % 16 != 0)
+    {
+        throw xlnt::exception("Invalid CBC ciphertext length ("
+            + std::to_string(len)
+            + " bytes). Must be a multiple of 16 bytes.");
+    }
+
+    if (len == 0) return;
+
     std::array<std::uint8_t, 16> temporary{{0}};
+    std::array<std::uint8_t, 16> iv_array{{0}};
+    std::copy(original_iv, original_iv + 16, iv_array.begin());
 
-    auto plaintext = std::vector<std::uint8_t>(len);
     auto expanded_key = rijndael_setup(key);
-    auto ct = ciphertext.data() + offset;
-    auto pt = plaintext.data();
-    auto iv_vec = original_iv;
-    auto iv = iv_vec.data();
+    auto ct = ciphertext;
+    auto pt = plaintext;
+    auto iv = iv_array.data();
+
+#ifdef XLNT_AES_NI
+    if (use_aes_ni())
+    {
+        aes_ni_cbc_decrypt(ct, pt, len, iv, expanded_key);
+        return;
+    }
+#endif
 
     while (len)
     {
@@ -3131,8 +3408,17 @@ std::vector<std::uint8_t> aes_cbc_decrypt(
         ct += 16;
         len -= 16;
     }
+}
 
-    return plaintext;
+bool aes_hardware_available()
+{
+    static const bool supported = cpu_supports_aes_ni();
+    return supported;
+}
+
+void aes_allow_hardware(bool allow)
+{
+    hardware_allowed.store(allow, std::memory_order_relaxed);
 }
 
 } // namespace detail
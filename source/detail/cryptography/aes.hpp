@@ -23,33 +23,57 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
+#include <xlnt/xlnt_config.hpp>
+
 namespace xlnt {
 namespace detail {
 
-std::vector<std::uint8_t> aes_ecb_encrypt(
+std::vector<std::uint8_t> XLNT_API aes_ecb_encrypt(
     const std::vector<std::uint8_t> &input,
     const std::vector<std::uint8_t> &key,
     const std::size_t offset = 0);
 
-std::vector<std::uint8_t> aes_ecb_decrypt(
+std::vector<std::uint8_t> XLNT_API aes_ecb_decrypt(
     const std::vector<std::uint8_t> &input,
     const std::vector<std::uint8_t> &key,
     const std::size_t offset = 0);
 
-std::vector<std::uint8_t> aes_cbc_encrypt(
+std::vector<std::uint8_t> XLNT_API aes_cbc_encrypt(
     const std::vector<std::uint8_t> &input,
     const std::vector<std::uint8_t> &key,
     const std::vector<std::uint8_t> &iv,
     const std::size_t offset = 0);
 
-std::vector<std::uint8_t> aes_cbc_decrypt(
+std::vector<std::uint8_t> XLNT_API aes_cbc_decrypt(
     const std::vector<std::uint8_t> &input,
     const std::vector<std::uint8_t> &key,
     const std::vector<std::uint8_t> &iv,
     const std::size_t offset = 0);
 
+// Decrypt size bytes, which must be a multiple of 16, from input into a
+// separate output buffer of at least the same size.
+void XLNT_API aes_ecb_decrypt(
+    const std::uint8_t *input,
+    std::size_t size,
+    const std::vector<std::uint8_t> &key,
+    std::uint8_t *output);
+
+void XLNT_API aes_cbc_decrypt(
+    const std::uint8_t *input,
+    std::size_t size,
+    const std::vector<std::uint8_t> &key,
+    const std::uint8_t *iv,
+    std::uint8_t *output);
+
+// The functions above use the processor's AES instructions when it has them.
+// aes_allow_hardware(false) forces the portable implementation, e.g. to compare the two.
+bool XLNT_API aes_hardware_available();
+
+void XLNT_API aes_allow_hardware(bool allow);
+
 } // namespace detail
 } // namespace xlnt
@@ -21,8 +21,11 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
+#include <exception>
+#include <thread>
 #include <vector>
 
 #include <xlnt/utils/exceptions.hpp>
@@ -45,29 +48,97 @@ using xlnt::detail::byte;
 using xlnt::detail::encryption_info;
 using xlnt::detail::read;
 
+// EncryptedPackage is encrypted in segments of this many bytes
+constexpr std::size_t segment_size = 4096;
+
+std::vector<std::uint8_t> read_encrypted_package(std::istream &encrypted_package_stream)
+{
+    std::vector<std::uint8_t> encrypted_package;
+    std::size_t size = 0;
+
+    while (encrypted_package_stream)
+    {
+        encrypted_package.resize(size + 64 * segment_size);
+        encrypted_package_stream.read(
+            reinterpret_cast<char *>(encrypted_package.data() + size),
+            static_cast<std::streamsize>(encrypted_package.size() - size));
+        size += static_cast<std::size_t>(encrypted_package_stream.gcount());
+    }
+
+    // a trailing partial AES block can't be decrypted and is never part of the package
+    encrypted_package.resize(size - size % 16);
+
+    return encrypted_package;
+}
+
+// Calls decrypt_segment for every segment index below count, giving each of up
+// to thread_count threads a contiguous run of segments.
+template <typename Function>
+void decrypt_segments(std::size_t count, std::size_t thread_count, Function decrypt_segment)
+{
+    thread_count = std::max(std::size_t(1), std::min(thread_count, count));
+    std::vector<std::exception_ptr> errors(thread_count);
+
+    auto decrypt_run = [&](std::size_t run) {
+        try
+        {
+            const auto last = count * (run + 1) / thread_count;
+
+            for (auto i = count * run / thread_count; i < last; ++i)
+            {
+                decrypt_segment(i);
+            }
+        }
+        catch (...)
+        {
+            errors[run] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+
+    for (std::size_t run = 1; run < thread_count; ++run)
+    {
+        workers.emplace_back(decrypt_run, run);
+    }
+
+    decrypt_run(0);
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    for (const auto &error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
 std::vector<std::uint8_t> decrypt_xlsx_standard(
     encryption_info info,
-    std::istream &encrypted_package_stream)
+    std::istream &encrypted_package_stream,
+    std::size_t thread_count)
 {
     const auto key = info.calculate_key();
 
     auto decrypted_size = read<std::uint64_t>(encrypted_package_stream);
+    const auto encrypted_package = read_encrypted_package(encrypted_package_stream);
+    std::vector<std::uint8_t> decrypted_package(encrypted_package.size());
 
-    std::vector<std::uint8_t> encrypted_segment(4096, 0);
-    std::vector<std::uint8_t> decrypted_package;
+    // ECB blocks are independent, segments are only a convenient unit of work
+    const auto segment_count = (encrypted_package.size() + segment_size - 1) / segment_size;
 
-    while (encrypted_package_stream)
-    {
-        encrypted_package_stream.read(
-            reinterpret_cast<char *>(encrypted_segment.data()),
-            static_cast<std::streamsize>(encrypted_segment.size()));
-        auto decrypted_segment = xlnt::detail::aes_ecb_decrypt(encrypted_segment, key);
-
-        decrypted_package.insert(
-            decrypted_package.end(),
-            decrypted_segment.begin(),
-            decrypted_segment.end());
-    }
+    decrypt_segments(segment_count, thread_count, [&](std::size_t segment) {
+        const auto offset = segment * segment_size;
+        const auto size = std::min(segment_size, encrypted_package.size() - offset);
+
+        xlnt::detail::aes_ecb_decrypt(encrypted_package.data() + offset, size, key,
+            decrypted_package.data() + offset);
+    });
 
     decrypted_package.resize(static_cast<std::size_t>(decrypted_size));
 
@@ -76,37 +147,37 @@ std::vector<std::uint8_t> decrypt_xlsx_standard(
 
 std::vector<std::uint8_t> decrypt_xlsx_agile(
     const encryption_info &info,
-    std::istream &encrypted_package_stream)
+    std::istream &encrypted_package_stream,
+    std::size_t thread_count)
 {
     const auto key = info.calculate_key();
+    const auto salt_size = info.agile.key_data.salt_size;
 
-    auto salt_size = info.agile.key_data.salt_size;
-    auto salt_with_block_key = info.agile.key_data.salt_value;
-    salt_with_block_key.resize(salt_size + sizeof(std::uint32_t), 0);
-
-    auto &segment = *reinterpret_cast<std::uint32_t *>(salt_with_block_key.data() + salt_size);
     auto total_size = read<std::uint64_t>(encrypted_package_stream);
+    const auto encrypted_package = read_encrypted_package(encrypted_package_stream);
+    std::vector<std::uint8_t> decrypted_package(encrypted_package.size());
 
-    std::vector<std::uint8_t> encrypted_segment(4096, 0);
-    std::vector<std::uint8_t> decrypted_package;
+    const auto segment_count = (encrypted_package.size() + segment_size - 1) / segment_size;
+
+    decrypt_segments(segment_count, thread_count, [&](std::size_t segment) {
+        // each segment's IV is the hash of the salt followed by the little-endian segment index
+        auto salt_with_block_key = info.agile.key_data.salt_value;
+        salt_with_block_key.resize(salt_size + sizeof(std::uint32_t), 0);
+
+        for (std::size_t i = 0; i < sizeof(std::uint32_t); ++i)
+        {
+            salt_with_block_key[salt_size + i] = static_cast<std::uint8_t>(segment >> (8 * i));
+        }
 
-    while (encrypted_package_stream)
-    {
         auto iv = hash(info.agile.key_encryptor.hash, salt_with_block_key);
         iv.resize(16);
 
-        encrypted_package_stream.read(
-            reinterpret_cast<char *>(encrypted_segment.data()),
-            static_cast<std::streamsize>(encrypted_segment.size()));
-        auto decrypted_segment = xlnt::detail::aes_cbc_decrypt(encrypted_segment, key, iv);
-
-        decrypted_package.insert(
-            decrypted_package.end(),
-            decrypted_segment.begin(),
-            decrypted_segment.end());
+        const auto offset = segment * segment_size;
+        const auto size = std::min(segment_size, encrypted_package.size() - offset);
 
-        ++segment;
-    }
+        xlnt::detail::aes_cbc_decrypt(encrypted_package.data() + offset, size, key, iv.data(),
+            decrypted_package.data() + offset);
+    });
 
     decrypted_package.resize(static_cast<std::size_t>(total_size));
 
@@ -308,7 +379,8 @@ encryption_info read_encryption_info(std::istream &info_stream, const std::u16st
 
 std::vector<std::uint8_t> decrypt_xlsx(
     const std::vector<std::uint8_t> &bytes,
-    const std::u16string &password)
+    const std::u16string &password,
+    std::size_t thread_count)
 {
     if (bytes.empty())
     {
@@ -325,8 +397,8 @@ std::vector<std::uint8_t> decrypt_xlsx(
     auto &encrypted_package_stream = document.open_read_stream("/EncryptedPackage");
 
     return encryption_info.is_agile
-        ? decrypt_xlsx_agile(encryption_info, encrypted_package_stream)
-        : decrypt_xlsx_standard(encryption_info, encrypted_package_stream);
+        ? decrypt_xlsx_agile(encryption_info, encrypted_package_stream, thread_count)
+        : decrypt_xlsx_standard(encryption_info, encrypted_package_stream, thread_count);
 }
 
 } // namespace
@@ -334,15 +406,20 @@ std::vector<std::uint8_t> decrypt_xlsx(
 namespace xlnt {
 namespace detail {
 
-std::vector<std::uint8_t> XLNT_API decrypt_xlsx(const std::vector<std::uint8_t> &data, const std::string &password)
+std::vector<std::uint8_t> XLNT_API decrypt_xlsx(const std::vector<std::uint8_t> &data, const std::string &password,
+    std::size_t thread_count)
 {
-    return ::decrypt_xlsx(data, utf8_to_utf16(password));
+    return ::decrypt_xlsx(data, utf8_to_utf16(password), thread_count);
 }
 
 void xlsx_consumer::read(std::istream &source, const std::string &password)
 {
+    auto decryption_threads = options_.decryption_threads == 0
+        ? static_cast<std::size_t>(std::thread::hardware_concurrency())
+        : options_.decryption_threads;
+
     std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(source)), (std::istreambuf_iterator<char>()));
-    const auto decrypted = decrypt_xlsx(data, password);
+    const auto decrypted = decrypt_xlsx(data, password, decryption_threads);
     vector_istreambuf decrypted_buffer(decrypted);
     std::istream decrypted_stream(&decrypted_buffer);
     read(decrypted_stream);
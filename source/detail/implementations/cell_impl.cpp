@@ -30,15 +30,113 @@ namespace xlnt {
 namespace detail {
 
 cell_impl::cell_impl()
-    : type_(cell_type::empty),
-      parent_(nullptr),
+    : parent_(nullptr),
+      value_numeric_(0),
+      format_(nullptr),
       column_(1),
       row_(1),
+      type_(cell_type::empty),
       is_merged_(false),
-      phonetics_visible_(false),
-      value_numeric_(0)
+      phonetics_visible_(false)
 {
 }
 
+cell_impl::cell_impl(const cell_impl &other)
+    : parent_(other.parent_),
+      value_numeric_(other.value_numeric_),
+      format_(other.format_),
+      column_(other.column_),
+      row_(other.row_),
+      type_(other.type_),
+      is_merged_(other.is_merged_),
+      phonetics_visible_(other.phonetics_visible_),
+      extra_(other.extra_ ? new cell_impl_extra(*other.extra_) : nullptr)
+{
+}
+
+cell_impl &cell_impl::operator=(const cell_impl &other)
+{
+    if (this != &other)
+    {
+        cell_impl copy(other);
+        *this = std::move(copy);
+    }
+
+    return *this;
+}
+
+cell_impl_extra &cell_impl::extra()
+{
+    if (!extra_)
+    {
+        extra_.reset(new cell_impl_extra());
+    }
+
+    return *extra_;
+}
+
+void cell_impl::release_extra_if_empty()
+{
+    if (extra_ && extra_->empty())
+    {
+        extra_.reset();
+    }
+}
+
+const std::shared_ptr<rich_text> &cell_impl::value_text() const
+{
+    static const auto none = std::shared_ptr<rich_text>();
+    return extra_ ? extra_->value_text_ : none;
+}
+
+void cell_impl::value_text(std::shared_ptr<rich_text> text)
+{
+    if (!text && !extra_) return;
+
+    extra().value_text_ = std::move(text);
+    release_extra_if_empty();
+}
+
+const std::optional<std::string> &cell_impl::formula() const
+{
+    static const auto none = std::optional<std::string>();
+    return extra_ ? extra_->formula_ : none;
+}
+
+void cell_impl::formula(std::optional<std::string> formula)
+{
+    if (!formula.has_value() && !extra_) return;
+
+    extra().formula_ = std::move(formula);
+    release_extra_if_empty();
+}
+
+const std::shared_ptr<hyperlink_impl> &cell_impl::hyperlink() const
+{
+    static const auto none = std::shared_ptr<hyperlink_impl>();
+    return extra_ ? extra_->hyperlink_ : none;
+}
+
+void cell_impl::hyperlink(std::shared_ptr<hyperlink_impl> hyperlink)
+{
+    if (!hyperlink && !extra_) return;
+
+    extra().hyperlink_ = std::move(hyperlink);
+    release_extra_if_empty();
+}
+
+comment *cell_impl::comment_ptr() const
+{
+    return extra_ ? extra_->comment_ : nullptr;
+}
+
+void cell_impl::comment_ptr(comment *comment)
+{
+    if (comment == nullptr && !extra_) return;
+
+    extra().comment_ = comment;
+    release_extra_if_empty();
+}
+
 } // namespace detail
 } // namespace xlnt
@@ -41,32 +41,70 @@ namespace detail {
 
 struct worksheet_impl;
 
+/// <summary>
+/// Cell data that most cells don't have. It is kept out of line and only
+/// allocated once one of these fields is set, so that a cell holding a plain
+/// number or shared string stays small.
+/// </summary>
+struct cell_impl_extra
+{
+    std::shared_ptr<rich_text> value_text_;
+    std::optional<std::string> formula_;
+    std::shared_ptr<hyperlink_impl> hyperlink_;
+    comment *comment_ = nullptr; // невладеющий
+
+    bool empty() const
+    {
+        return !value_text_ && !formula_.has_value() && !hyperlink_ && comment_ == nullptr;
+    }
+};
+
 struct cell_impl
 {
     cell_impl();
+    cell_impl(const cell_impl &other);
+    cell_impl(cell_impl &&other) = default;
 
-    cell_type type_;
+    cell_impl &operator=(const cell_impl &other);
+    cell_impl &operator=(cell_impl &&other) = default;
 
     worksheet_impl *parent_;
 
+    // number, boolean, or shared string index depending on type_
+    double value_numeric_;
+    format_impl *format_; // невладеющий
+
     column_t column_;
     row_t row_;
 
+    cell_type type_;
+
     bool is_merged_;
     bool phonetics_visible_;
 
-    std::shared_ptr<rich_text> value_text_;
-    double value_numeric_;
+    const std::shared_ptr<rich_text> &value_text() const;
+    void value_text(std::shared_ptr<rich_text> text);
 
-    std::optional<std::string> formula_;
-    std::shared_ptr<hyperlink_impl> hyperlink_;
-    format_impl* format_; // невладеющий
-    comment* comment_; // невладеющий
+    const std::optional<std::string> &formula() const;
+    void formula(std::optional<std::string> formula);
+
+    const std::shared_ptr<hyperlink_impl> &hyperlink() const;
+    void hyperlink(std::shared_ptr<hyperlink_impl> hyperlink);
+
+    comment *comment_ptr() const;
+    void comment_ptr(comment *comment);
 
     bool is_garbage_collectible() const
     {
-        return !(type_ != cell_type::empty || is_merged_ || phonetics_visible_ || formula_.has_value() || format_ != nullptr || hyperlink_);
+        return !(type_ != cell_type::empty || is_merged_ || phonetics_visible_ || format_ != nullptr
+            || (extra_ && (extra_->formula_.has_value() || extra_->hyperlink_)));
     }
+
+private:
+    cell_impl_extra &extra();
+    void release_extra_if_empty();
+
+    std::unique_ptr<cell_impl_extra> extra_;
 };
 
 inline bool operator==(const cell_impl &lhs, const cell_impl &rhs)
@@ -77,12 +115,12 @@ inline bool operator==(const cell_impl &lhs, const cell_impl &rhs)
         && lhs.row_ == rhs.row_
         && lhs.is_merged_ == rhs.is_merged_
         && lhs.phonetics_visible_ == rhs.phonetics_visible_
-        && lhs.value_text_ == rhs.value_text_
+        && lhs.value_text() == rhs.value_text()
         && float_equals(lhs.value_numeric_, rhs.value_numeric_)
-        && lhs.formula_ == rhs.formula_
-        && lhs.hyperlink_ == rhs.hyperlink_
+        && lhs.formula() == rhs.formula()
+        && lhs.hyperlink() == rhs.hyperlink()
         && lhs.format_ == rhs.format_
-        && lhs.comment_ == rhs.comment_;
+        && lhs.comment_ptr() == rhs.comment_ptr();
 }
 
 } // namespace detail
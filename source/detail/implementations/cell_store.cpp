@@ -0,0 +1,370 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <algorithm>
+
+#include <detail/implementations/cell_store.hpp>
+
+namespace {
+
+// Cells are pooled in chunks that start small, so that sheets with a handful
+// of cells stay cheap, and grow geometrically up to this size.
+constexpr std::size_t min_chunk_size = 16;
+constexpr std::size_t max_chunk_size = 4096;
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+cell_store::cell_store(const cell_store &other)
+{
+    *this = other;
+}
+
+cell_store &cell_store::operator=(const cell_store &other)
+{
+    if (this == &other) return *this;
+
+    clear();
+    reserve(other.size());
+
+    for (const auto &impl : other)
+    {
+        auto copy = impl;
+        emplace(std::move(copy));
+    }
+
+    return *this;
+}
+
+std::vector<cell_store::slot> *cell_store::row_slots(row_t row)
+{
+    const auto block_index = row / rows_per_block;
+
+    if (block_index >= blocks_.size() || !blocks_[block_index])
+    {
+        return nullptr;
+    }
+
+    return &blocks_[block_index]->rows[row % rows_per_block];
+}
+
+const std::vector<cell_store::slot> *cell_store::row_slots(row_t row) const
+{
+    return const_cast<cell_store *>(this)->row_slots(row);
+}
+
+cell_impl *cell_store::find(const cell_reference &reference)
+{
+    auto slots = row_slots(reference.row());
+    if (slots == nullptr) return nullptr;
+
+    const auto column = reference.column_index();
+    auto match = std::lower_bound(slots->begin(), slots->end(), column,
+        [](const slot &s, column_t::index_t c) { return s.column < c; });
+
+    return match != slots->end() && match->column == column ? match->impl : nullptr;
+}
+
+const cell_impl *cell_store::find(const cell_reference &reference) const
+{
+    return const_cast<cell_store *>(this)->find(reference);
+}
+
+std::pair<cell_impl *, bool> cell_store::emplace(cell_impl &&impl)
+{
+    const auto row = impl.row_;
+    const auto column = impl.column_.index;
+    const auto block_index = row / rows_per_block;
+
+    if (block_index >= blocks_.size())
+    {
+        blocks_.resize(block_index + 1);
+    }
+
+    auto &block = blocks_[block_index];
+    if (!block)
+    {
+        block.reset(new row_block());
+    }
+
+    auto &slots = block->rows[row % rows_per_block];
+    auto position = slots.end();
+
+    // cells almost always arrive in column order, so check the end first
+    if (!slots.empty() && slots.back().column >= column)
+    {
+        position = std::lower_bound(slots.begin(), slots.end(), column,
+            [](const slot &s, column_t::index_t c) { return s.column < c; });
+
+        if (position->column == column)
+        {
+            return {position->impl, false};
+        }
+    }
+
+    auto stored = allocate();
+    *stored = std::move(impl);
+    slots.insert(position, slot{column, stored});
+
+    ++block->size;
+    ++size_;
+    extend_bounds(row, column);
+
+    if (stored->type_ == cell_type::shared_string)
+    {
+        ++shared_string_count_;
+    }
+
+    return {stored, true};
+}
+
+cell_impl *cell_store::insert_or_assign(const cell_impl &impl)
+{
+    auto copy = impl;
+    auto result = emplace(std::move(copy));
+
+    if (!result.second)
+    {
+        set_type(*result.first, impl.type_);
+        *result.first = impl;
+    }
+
+    return result.first;
+}
+
+void cell_store::set_type(cell_impl &impl, cell_type type)
+{
+    const auto was_shared = impl.type_ == cell_type::shared_string;
+    const auto is_shared = type == cell_type::shared_string;
+    impl.type_ = type;
+
+    if (was_shared == is_shared || find(cell_reference(impl.column_, impl.row_)) != &impl)
+    {
+        return;
+    }
+
+    if (is_shared)
+    {
+        ++shared_string_count_;
+    }
+    else
+    {
+        --shared_string_count_;
+    }
+}
+
+bool cell_store::erase(const cell_reference &reference)
+{
+    auto slots = row_slots(reference.row());
+    if (slots == nullptr) return false;
+
+    const auto column = reference.column_index();
+    auto match = std::lower_bound(slots->begin(), slots->end(), column,
+        [](const slot &s, column_t::index_t c) { return s.column < c; });
+
+    if (match == slots->end() || match->column != column)
+    {
+        return false;
+    }
+
+    release(match->impl);
+    slots->erase(match);
+    --blocks_[reference.row() / rows_per_block]->size;
+    --size_;
+
+    if (reference.row() == lowest_row_ || reference.row() == highest_row_
+        || column == lowest_column_ || column == highest_column_)
+    {
+        bounds_dirty_ = true;
+    }
+
+    return true;
+}
+
+void cell_store::erase_row(row_t row)
+{
+    auto slots = row_slots(row);
+    if (slots == nullptr || slots->empty()) return;
+
+    for (auto &entry : *slots)
+    {
+        release(entry.impl);
+    }
+
+    blocks_[row / rows_per_block]->size -= slots->size();
+    size_ -= slots->size();
+    slots->clear();
+
+    bounds_dirty_ = true;
+}
+
+void cell_store::reserve(std::size_t n)
+{
+    const auto available = free_.size() + (chunk_capacity_ - chunk_used_);
+    if (size_ + available >= n) return;
+
+    const auto needed = n - size_ - available;
+
+    // the remainder of the current chunk is abandoned to the free list
+    while (chunk_used_ < chunk_capacity_)
+    {
+        free_.push_back(&chunks_.back()[chunk_used_++]);
+    }
+
+    chunks_.emplace_back(new cell_impl[needed]);
+    chunk_used_ = 0;
+    chunk_capacity_ = needed;
+}
+
+void cell_store::clear()
+{
+    blocks_.clear();
+    chunks_.clear();
+    free_.clear();
+    chunk_used_ = 0;
+    chunk_capacity_ = 0;
+    size_ = 0;
+    shared_string_count_ = 0;
+    bounds_dirty_ = false;
+}
+
+cell_impl *cell_store::allocate()
+{
+    if (!free_.empty())
+    {
+        auto impl = free_.back();
+        free_.pop_back();
+        return impl;
+    }
+
+    if (chunk_used_ == chunk_capacity_)
+    {
+        const auto capacity = chunks_.empty()
+            ? min_chunk_size
+            : std::min(max_chunk_size, std::max(min_chunk_size, chunk_capacity_ * 2));
+        chunks_.emplace_back(new cell_impl[capacity]);
+        chunk_used_ = 0;
+        chunk_capacity_ = capacity;
+    }
+
+    return &chunks_.back()[chunk_used_++];
+}
+
+void cell_store::release(cell_impl *impl)
+{
+    if (impl->type_ == cell_type::shared_string)
+    {
+        --shared_string_count_;
+    }
+
+    // drop shared values now rather than when the slot is reused
+    *impl = cell_impl();
+    free_.push_back(impl);
+}
+
+void cell_store::extend_bounds(row_t row, column_t::index_t column)
+{
+    if (bounds_dirty_) return;
+
+    if (size_ == 1)
+    {
+        lowest_row_ = highest_row_ = row;
+        lowest_column_ = highest_column_ = column;
+        return;
+    }
+
+    lowest_row_ = std::min(lowest_row_, row);
+    highest_row_ = std::max(highest_row_, row);
+    lowest_column_ = std::min(lowest_column_, column);
+    highest_column_ = std::max(highest_column_, column);
+}
+
+void cell_store::update_bounds() const
+{
+    if (!bounds_dirty_) return;
+
+    bounds_dirty_ = false;
+    bool first = true;
+
+    for (std::size_t block_index = 0; block_index < blocks_.size(); ++block_index)
+    {
+        const auto &block = blocks_[block_index];
+        if (!block || block->size == 0) continue;
+
+        for (std::size_t row_index = 0; row_index < rows_per_block; ++row_index)
+        {
+            const auto &slots = block->rows[row_index];
+            if (slots.empty()) continue;
+
+            const auto row = static_cast<row_t>(block_index * rows_per_block + row_index);
+
+            if (first)
+            {
+                lowest_row_ = row;
+                lowest_column_ = slots.front().column;
+                highest_column_ = slots.back().column;
+                first = false;
+            }
+
+            highest_row_ = row;
+            lowest_column_ = std::min(lowest_column_, slots.front().column);
+            highest_column_ = std::max(highest_column_, slots.back().column);
+        }
+    }
+}
+
+row_t cell_store::lowest_row() const
+{
+    update_bounds();
+    return lowest_row_;
+}
+
+row_t cell_store::highest_row() const
+{
+    update_bounds();
+    return highest_row_;
+}
+
+column_t cell_store::lowest_column() const
+{
+    update_bounds();
+    return lowest_column_;
+}
+
+column_t cell_store::highest_column() const
+{
+    update_bounds();
+    return highest_column_;
+}
+
+bool cell_store::operator==(const cell_store &other) const
+{
+    if (size_ != other.size_) return false;
+
+    return std::equal(begin(), end(), other.begin());
+}
+
+} // namespace detail
+} // namespace xlnt
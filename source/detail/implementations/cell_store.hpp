@@ -0,0 +1,323 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <xlnt/cell/cell_reference.hpp>
+#include <detail/implementations/cell_impl.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Row-major storage for the cells of a worksheet.
+/// Rows are grouped into fixed-size blocks, each row holding a column-sorted
+/// vector of cells, so lookups are a block index plus a binary search and
+/// iteration visits cells in row-major order. The cell_impl objects themselves
+/// live in chunked pools and never move, since xlnt::cell holds raw pointers
+/// to them. Bounds are maintained incrementally on insertion and recomputed
+/// lazily only after a boundary cell has been erased. The number of shared
+/// string cells is kept up to date as cells are stored, retyped and removed
+/// so that writing the shared string table doesn't need to scan the sheet.
+/// </summary>
+class cell_store
+{
+    struct slot
+    {
+        column_t::index_t column;
+        cell_impl *impl;
+    };
+
+    static constexpr std::size_t rows_per_block = 256;
+
+    struct row_block
+    {
+        std::array<std::vector<slot>, rows_per_block> rows;
+        std::size_t size = 0;
+    };
+
+public:
+    template <bool is_const>
+    class basic_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = cell_impl;
+        using difference_type = std::ptrdiff_t;
+        using pointer = typename std::conditional<is_const, const cell_impl *, cell_impl *>::type;
+        using reference = typename std::conditional<is_const, const cell_impl &, cell_impl &>::type;
+        using store_pointer = typename std::conditional<is_const, const cell_store *, cell_store *>::type;
+
+        basic_iterator() = default;
+
+        basic_iterator(store_pointer store, std::size_t block, std::size_t row, std::size_t column)
+            : store_(store), block_(block), row_(row), column_(column)
+        {
+            skip_empty();
+        }
+
+        operator basic_iterator<true>() const
+        {
+            return basic_iterator<true>(store_, block_, row_, column_);
+        }
+
+        reference operator*() const
+        {
+            return *store_->blocks_[block_]->rows[row_][column_].impl;
+        }
+
+        pointer operator->() const
+        {
+            return store_->blocks_[block_]->rows[row_][column_].impl;
+        }
+
+        basic_iterator &operator++()
+        {
+            ++column_;
+            skip_empty();
+            return *this;
+        }
+
+        basic_iterator operator++(int)
+        {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const basic_iterator &other) const
+        {
+            return block_ == other.block_ && row_ == other.row_ && column_ == other.column_;
+        }
+
+        bool operator!=(const basic_iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        void skip_empty()
+        {
+            const auto &blocks = store_->blocks_;
+
+            while (block_ < blocks.size())
+            {
+                const auto &block = blocks[block_];
+
+                if (block && block->size > 0)
+                {
+                    while (row_ < rows_per_block)
+                    {
+                        if (column_ < block->rows[row_].size()) return;
+                        ++row_;
+                        column_ = 0;
+                    }
+                }
+
+                ++block_;
+                row_ = 0;
+                column_ = 0;
+            }
+
+            row_ = 0;
+            column_ = 0;
+        }
+
+        store_pointer store_ = nullptr;
+        std::size_t block_ = 0;
+        std::size_t row_ = 0;
+        std::size_t column_ = 0;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    cell_store() = default;
+    cell_store(const cell_store &other);
+    cell_store(cell_store &&other) = default;
+    ~cell_store() = default;
+
+    cell_store &operator=(const cell_store &other);
+    cell_store &operator=(cell_store &&other) = default;
+
+    /// <summary>
+    /// Returns the cell at the given reference or nullptr if it doesn't exist.
+    /// </summary>
+    cell_impl *find(const cell_reference &reference);
+
+    /// <summary>
+    /// Returns the cell at the given reference or nullptr if it doesn't exist.
+    /// </summary>
+    const cell_impl *find(const cell_reference &reference) const;
+
+    /// <summary>
+    /// Moves impl into the store at its own column_/row_ unless a cell already
+    /// exists there. Returns the stored cell and whether an insertion took place.
+    /// </summary>
+    std::pair<cell_impl *, bool> emplace(cell_impl &&impl);
+
+    /// <summary>
+    /// Stores a copy of impl at its own column_/row_, replacing any existing cell.
+    /// </summary>
+    cell_impl *insert_or_assign(const cell_impl &impl);
+
+    /// <summary>
+    /// Changes the type of a cell, keeping the shared string count in step.
+    /// Cells that don't belong to this store are retyped without being counted.
+    /// </summary>
+    void set_type(cell_impl &impl, cell_type type);
+
+    /// <summary>
+    /// Removes the cell at the given reference. Returns true if one was removed.
+    /// </summary>
+    bool erase(const cell_reference &reference);
+
+    /// <summary>
+    /// Removes every cell in the given row.
+    /// </summary>
+    void erase_row(row_t row);
+
+    /// <summary>
+    /// Removes every cell for which predicate returns true.
+    /// </summary>
+    template <typename Predicate>
+    void erase_if(Predicate predicate)
+    {
+        for (auto &block : blocks_)
+        {
+            if (!block || block->size == 0) continue;
+
+            for (auto &row : block->rows)
+            {
+                auto kept = row.begin();
+
+                for (auto &entry : row)
+                {
+                    if (predicate(static_cast<const cell_impl &>(*entry.impl)))
+                    {
+                        release(entry.impl);
+                        --block->size;
+                        --size_;
+                    }
+                    else
+                    {
+                        *kept++ = entry;
+                    }
+                }
+
+                row.erase(kept, row.end());
+            }
+        }
+
+        bounds_dirty_ = true;
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    /// <summary>
+    /// Returns the number of stored cells of type shared_string.
+    /// </summary>
+    std::size_t shared_string_count() const
+    {
+        return shared_string_count_;
+    }
+
+    /// <summary>
+    /// Preallocates storage for at least n cells in total.
+    /// </summary>
+    void reserve(std::size_t n);
+
+    void clear();
+
+    /// <summary>
+    /// Bounds of the stored cells. Only meaningful when the store isn't empty.
+    /// </summary>
+    row_t lowest_row() const;
+    row_t highest_row() const;
+    column_t lowest_column() const;
+    column_t highest_column() const;
+
+    iterator begin()
+    {
+        return iterator(this, 0, 0, 0);
+    }
+
+    iterator end()
+    {
+        return iterator(this, blocks_.size(), 0, 0);
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(this, 0, 0, 0);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(this, blocks_.size(), 0, 0);
+    }
+
+    bool operator==(const cell_store &other) const;
+
+private:
+    std::vector<slot> *row_slots(row_t row);
+    const std::vector<slot> *row_slots(row_t row) const;
+
+    cell_impl *allocate();
+    void release(cell_impl *impl);
+    void extend_bounds(row_t row, column_t::index_t column);
+    void update_bounds() const;
+
+    std::vector<std::unique_ptr<row_block>> blocks_;
+    std::size_t size_ = 0;
+    std::size_t shared_string_count_ = 0;
+
+    std::vector<std::unique_ptr<cell_impl[]>> chunks_;
+    std::size_t chunk_used_ = 0;
+    std::size_t chunk_capacity_ = 0;
+    std::vector<cell_impl *> free_;
+
+    mutable bool bounds_dirty_ = false;
+    mutable row_t lowest_row_ = 0;
+    mutable row_t highest_row_ = 0;
+    mutable column_t::index_t lowest_column_ = 0;
+    mutable column_t::index_t highest_column_ = 0;
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,134 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <detail/implementations/format_store.hpp>
+#include <detail/implementations/style_hash.hpp>
+
+namespace xlnt {
+namespace detail {
+
+format_store::format_store(const format_store &other)
+    : formats_(other.formats_)
+{
+    rebuild_index();
+    reindex();
+}
+
+format_store &format_store::operator=(const format_store &other)
+{
+    if (this == &other) return *this;
+
+    formats_ = other.formats_;
+    rebuild_index();
+    reindex();
+
+    return *this;
+}
+
+format_impl &format_store::push_back(const format_impl &impl)
+{
+    formats_.push_back(impl);
+
+    auto &stored = formats_.back();
+    index_.push_back(&stored);
+    by_value_.emplace(style_hash()(stored), &stored);
+
+    return stored;
+}
+
+format_impl *format_store::find(const format_impl &pattern)
+{
+    const auto candidates = by_value_.equal_range(style_hash()(pattern));
+    format_impl *found = nullptr;
+
+    for (auto candidate = candidates.first; candidate != candidates.second; ++candidate)
+    {
+        if ((found == nullptr || candidate->second->id < found->id) && *candidate->second == pattern)
+        {
+            found = candidate->second;
+        }
+    }
+
+    return found;
+}
+
+void format_store::assign(format_impl &target, const format_impl &value)
+{
+    unindex(target);
+    target = value;
+    by_value_.emplace(style_hash()(target), &target);
+}
+
+void format_store::pop_back()
+{
+    unindex(formats_.back());
+    formats_.pop_back();
+    index_.pop_back();
+}
+
+void format_store::reindex()
+{
+    by_value_.clear();
+    by_value_.reserve(formats_.size());
+
+    for (auto &impl : formats_)
+    {
+        by_value_.emplace(style_hash()(impl), &impl);
+    }
+}
+
+void format_store::clear()
+{
+    formats_.clear();
+    index_.clear();
+    by_value_.clear();
+}
+
+void format_store::unindex(const format_impl &impl)
+{
+    const auto candidates = by_value_.equal_range(style_hash()(impl));
+
+    for (auto candidate = candidates.first; candidate != candidates.second; ++candidate)
+    {
+        if (candidate->second == &impl)
+        {
+            by_value_.erase(candidate);
+            return;
+        }
+    }
+}
+
+void format_store::rebuild_index()
+{
+    index_.clear();
+    index_.reserve(formats_.size());
+
+    for (auto &impl : formats_)
+    {
+        index_.push_back(&impl);
+    }
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,192 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include <detail/implementations/format_impl.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Storage for the cell formats of a stylesheet.
+/// The format_impl objects live in a list so that they never move, since
+/// xlnt::format and cell_impl hold raw pointers to them, while a parallel
+/// vector of pointers in id order makes lookup by index constant time and a
+/// hash index makes lookup by value constant time. The indexes are kept in
+/// step with every mutation, including copies, so concurrent readers never
+/// see them being rebuilt. Stored formats must therefore only be changed
+/// through assign, or followed by a call to reindex.
+/// </summary>
+class format_store
+{
+public:
+    using iterator = std::list<format_impl>::iterator;
+    using const_iterator = std::list<format_impl>::const_iterator;
+
+    format_store() = default;
+    format_store(const format_store &other);
+    format_store(format_store &&other) = default;
+    ~format_store() = default;
+
+    format_store &operator=(const format_store &other);
+    format_store &operator=(format_store &&other) = default;
+
+    /// <summary>
+    /// Appends impl and returns the stored format. Its position is size() - 1.
+    /// </summary>
+    format_impl &push_back(const format_impl &impl);
+
+    /// <summary>
+    /// Returns the format at the given position or nullptr if it's out of range.
+    /// </summary>
+    format_impl *at(std::size_t index)
+    {
+        return index < index_.size() ? index_[index] : nullptr;
+    }
+
+    /// <summary>
+    /// Returns the format at the given position or nullptr if it's out of range.
+    /// </summary>
+    const format_impl *at(std::size_t index) const
+    {
+        return index < index_.size() ? index_[index] : nullptr;
+    }
+
+    /// <summary>
+    /// Returns the stored format with the lowest id that is equal to pattern
+    /// or nullptr if there's none.
+    /// </summary>
+    format_impl *find(const format_impl &pattern);
+
+    /// <summary>
+    /// Replaces the stored format target with value.
+    /// </summary>
+    void assign(format_impl &target, const format_impl &value);
+
+    /// <summary>
+    /// Rebuilds the hash index after stored formats were changed in place.
+    /// </summary>
+    void reindex();
+
+    /// <summary>
+    /// Removes every format for which predicate returns true, keeping the
+    /// relative order of the rest.
+    /// </summary>
+    template <typename Predicate>
+    void erase_if(Predicate predicate)
+    {
+        // equal formats share a hash bucket, so unindexing one by one gets
+        // quadratic when many are removed at once and a rebuild is cheaper
+        constexpr std::size_t unindex_limit = 8;
+
+        auto iter = formats_.begin();
+        std::size_t erased = 0;
+
+        while (iter != formats_.end())
+        {
+            if (predicate(static_cast<const format_impl &>(*iter)))
+            {
+                if (++erased <= unindex_limit)
+                {
+                    unindex(*iter);
+                }
+
+                iter = formats_.erase(iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+
+        if (erased > unindex_limit)
+        {
+            reindex();
+        }
+
+        if (erased > 0)
+        {
+            rebuild_index();
+        }
+    }
+
+    /// <summary>
+    /// Removes the format with the highest id.
+    /// </summary>
+    void pop_back();
+
+    std::size_t size() const
+    {
+        return index_.size();
+    }
+
+    bool empty() const
+    {
+        return index_.empty();
+    }
+
+    void clear();
+
+    iterator begin()
+    {
+        return formats_.begin();
+    }
+
+    iterator end()
+    {
+        return formats_.end();
+    }
+
+    const_iterator begin() const
+    {
+        return formats_.begin();
+    }
+
+    const_iterator end() const
+    {
+        return formats_.end();
+    }
+
+    bool operator==(const format_store &other) const
+    {
+        return formats_ == other.formats_;
+    }
+
+private:
+    void unindex(const format_impl &impl);
+    void rebuild_index();
+
+    std::list<format_impl> formats_;
+    std::vector<format_impl *> index_;
+    std::unordered_multimap<std::size_t, format_impl *> by_value_;
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,123 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <detail/implementations/shared_string_table.hpp>
+
+namespace {
+
+constexpr std::size_t initial_capacity = 64;
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+std::uint32_t shared_string_table::fold(std::size_t hash)
+{
+    return static_cast<std::uint32_t>(hash ^ (hash >> 16 >> 16));
+}
+
+template <typename Text>
+std::size_t shared_string_table::find(const std::vector<rich_text> &values, const Text &text, std::uint32_t hash) const
+{
+    if (slots_.empty()) return npos;
+
+    const auto mask = slots_.size() - 1;
+
+    for (auto i = hash & mask; slots_[i].position != 0; i = (i + 1) & mask)
+    {
+        if (slots_[i].hash == hash && values[slots_[i].position - 1] == text)
+        {
+            return slots_[i].position - 1;
+        }
+    }
+
+    return npos;
+}
+
+std::size_t shared_string_table::find(const std::vector<rich_text> &values, const rich_text &text) const
+{
+    return find(values, text, fold(rich_text_hash()(text)));
+}
+
+std::size_t shared_string_table::find(const std::vector<rich_text> &values, const std::string &plain_text) const
+{
+    return find(values, plain_text, fold(rich_text_hash()(plain_text)));
+}
+
+void shared_string_table::insert(const std::vector<rich_text> &values, std::size_t index)
+{
+    const auto &text = values[index];
+    const auto hash = fold(rich_text_hash()(text));
+
+    if (find(values, text, hash) != npos) return;
+
+    // keep the load factor at or below one half
+    if ((size_ + 1) * 2 > slots_.size())
+    {
+        grow();
+    }
+
+    const auto mask = slots_.size() - 1;
+    auto i = hash & mask;
+
+    while (slots_[i].position != 0)
+    {
+        i = (i + 1) & mask;
+    }
+
+    slots_[i] = slot{static_cast<std::uint32_t>(index + 1), hash};
+    ++size_;
+}
+
+void shared_string_table::clear()
+{
+    slots_.clear();
+    size_ = 0;
+}
+
+void shared_string_table::grow()
+{
+    auto old_slots = std::move(slots_);
+    slots_.assign(old_slots.empty() ? initial_capacity : old_slots.size() * 2, slot{0, 0});
+
+    const auto mask = slots_.size() - 1;
+
+    for (const auto &old : old_slots)
+    {
+        if (old.position == 0) continue;
+
+        auto i = old.hash & mask;
+
+        while (slots_[i].position != 0)
+        {
+            i = (i + 1) & mask;
+        }
+
+        slots_[i] = old;
+    }
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,87 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <xlnt/cell/rich_text.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Interning table for the shared strings of a workbook.
+/// The strings themselves are only stored once, in the workbook's vector of
+/// shared strings; this is an open-addressing hash table of positions in that
+/// vector, eight bytes per slot including a 32-bit hash tag that rules out
+/// most mismatches without comparing strings. Plain strings can be looked up
+/// without constructing a rich_text.
+/// </summary>
+class shared_string_table
+{
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /// <summary>
+    /// Returns the position of the first string in values equal to text or npos.
+    /// </summary>
+    std::size_t find(const std::vector<rich_text> &values, const rich_text &text) const;
+
+    /// <summary>
+    /// Returns the position of the first string in values that is a single
+    /// unformatted run of plain_text or npos.
+    /// </summary>
+    std::size_t find(const std::vector<rich_text> &values, const std::string &plain_text) const;
+
+    /// <summary>
+    /// Adds values[index] to the table unless an equal string is already in it.
+    /// </summary>
+    void insert(const std::vector<rich_text> &values, std::size_t index);
+
+    void clear();
+
+private:
+    struct slot
+    {
+        std::uint32_t position; // index + 1, 0 for an empty slot
+        std::uint32_t hash;
+    };
+
+    static std::uint32_t fold(std::size_t hash);
+
+    template <typename Text>
+    std::size_t find(const std::vector<rich_text> &values, const Text &text, std::uint32_t hash) const;
+
+    void grow();
+
+    std::vector<slot> slots_;
+    std::size_t size_ = 0;
+};
+
+} // namespace detail
+} // namespace xlnt
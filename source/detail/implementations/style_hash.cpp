@@ -0,0 +1,223 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+#include <detail/implementations/style_hash.hpp>
+
+namespace {
+
+void combine(std::size_t &seed, std::size_t value)
+{
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+void combine(std::size_t &seed, double value)
+{
+    // 0.0 and -0.0 compare equal so they have to hash equal
+    combine(seed, std::hash<double>()(value == 0.0 ? 0.0 : value));
+}
+
+void combine(std::size_t &seed, const std::string &value)
+{
+    combine(seed, std::hash<std::string>()(value));
+}
+
+template <typename T>
+typename std::enable_if<std::is_enum<T>::value || std::is_integral<T>::value>::type
+combine(std::size_t &seed, T value)
+{
+    combine(seed, static_cast<std::size_t>(value));
+}
+
+void combine(std::size_t &seed, const xlnt::color &value);
+
+template <typename T>
+void combine(std::size_t &seed, const std::optional<T> &value)
+{
+    combine(seed, value.has_value());
+
+    if (value.has_value())
+    {
+        combine(seed, value.value());
+    }
+}
+
+void combine(std::size_t &seed, const xlnt::color &value)
+{
+    combine(seed, xlnt::detail::style_hash()(value));
+}
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+std::size_t style_hash::operator()(const alignment &value) const
+{
+    std::size_t seed = 0;
+
+    combine(seed, value.horizontal());
+    combine(seed, value.vertical());
+    combine(seed, value.indent());
+    combine(seed, value.rotation());
+    combine(seed, value.wrap());
+    combine(seed, value.shrink());
+
+    return seed;
+}
+
+std::size_t style_hash::operator()(const border &value) const
+{
+    std::size_t seed = 0;
+
+    for (auto side : border::all_sides())
+    {
+        const auto property = value.side(side);
+        combine(seed, property.has_value());
+
+        if (property.has_value())
+        {
+            combine(seed, property.value().style());
+            combine(seed, property.value().color());
+        }
+    }
+
+    return seed;
+}
+
+std::size_t style_hash::operator()(const color &value) const
+{
+    std::size_t seed = 0;
+
+    combine(seed, value.type());
+    combine(seed, value.auto_());
+
+    if (value.has_tint())
+    {
+        combine(seed, value.tint());
+    }
+
+    switch (value.type())
+    {
+    case color_type::indexed:
+        combine(seed, value.indexed().index());
+        break;
+    case color_type::theme:
+        combine(seed, value.theme().index());
+        break;
+    case color_type::rgb:
+        for (auto channel : value.rgb().rgba())
+        {
+            combine(seed, channel);
+        }
+        break;
+    }
+
+    return seed;
+}
+
+std::size_t style_hash::operator()(const fill &value) const
+{
+    std::size_t seed = 0;
+
+    combine(seed, value.type());
+
+    if (value.type() == fill_type::pattern)
+    {
+        const auto pattern = value.pattern_fill();
+        combine(seed, pattern.type());
+        combine(seed, pattern.foreground());
+        combine(seed, pattern.background());
+    }
+    else
+    {
+        const auto gradient = value.gradient_fill();
+        combine(seed, gradient.type());
+        combine(seed, gradient.degree());
+    }
+
+    return seed;
+}
+
+std::size_t style_hash::operator()(const font &value) const
+{
+    std::size_t seed = 0;
+
+    combine(seed, value.has_name());
+    if (value.has_name()) combine(seed, value.name());
+    combine(seed, value.has_size());
+    if (value.has_size()) combine(seed, value.size());
+    combine(seed, value.has_color());
+    if (value.has_color()) combine(seed, value.color());
+    combine(seed, value.bold());
+    combine(seed, value.italic());
+    combine(seed, value.underline());
+
+    return seed;
+}
+
+std::size_t style_hash::operator()(const number_format &value) const
+{
+    return std::hash<std::string>()(value.format_string());
+}
+
+std::size_t style_hash::operator()(const protection &value) const
+{
+    std::size_t seed = 0;
+
+    combine(seed, value.locked());
+    combine(seed, value.hidden());
+
+    return seed;
+}
+
+std::size_t style_hash::operator()(const format_impl &value) const
+{
+    std::size_t seed = 0;
+
+    combine(seed, value.alignment_id);
+    combine(seed, value.alignment_applied);
+    combine(seed, value.border_id);
+    combine(seed, value.border_applied);
+    combine(seed, value.fill_id);
+    combine(seed, value.fill_applied);
+    combine(seed, value.font_id);
+    combine(seed, value.font_applied);
+    combine(seed, value.number_format_id);
+    combine(seed, value.number_format_applied);
+    combine(seed, value.protection_id);
+    combine(seed, value.protection_applied);
+    combine(seed, value.pivot_button_);
+    combine(seed, value.quote_prefix_);
+    combine(seed, value.style);
+
+    return seed;
+}
+
+} // namespace detail
+} // namespace xlnt
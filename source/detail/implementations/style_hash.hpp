@@ -0,0 +1,135 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include <xlnt/styles/alignment.hpp>
+#include <xlnt/styles/border.hpp>
+#include <xlnt/styles/color.hpp>
+#include <xlnt/styles/fill.hpp>
+#include <xlnt/styles/font.hpp>
+#include <xlnt/styles/number_format.hpp>
+#include <xlnt/styles/protection.hpp>
+#include <detail/implementations/format_impl.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Structural hashes of the stylesheet records, consistent with their
+/// operator==. Only the fields that usually tell records apart are hashed,
+/// the rest are left to the equality check.
+/// </summary>
+struct style_hash
+{
+    std::size_t operator()(const alignment &value) const;
+    std::size_t operator()(const border &value) const;
+    std::size_t operator()(const color &value) const;
+    std::size_t operator()(const fill &value) const;
+    std::size_t operator()(const font &value) const;
+    std::size_t operator()(const number_format &value) const;
+    std::size_t operator()(const protection &value) const;
+    std::size_t operator()(const format_impl &value) const;
+};
+
+/// <summary>
+/// Hash index over one of the record vectors of a stylesheet, mapping records
+/// to their positions. Records appended to the vector directly, as the reader
+/// does, are picked up on the next lookup. The index must be cleared whenever
+/// records are removed or changed in place.
+/// </summary>
+template <typename T>
+class record_index
+{
+public:
+    /// <summary>
+    /// Returns the position of the first record in container equal to item or
+    /// container.size() if there's none.
+    /// </summary>
+    std::size_t find(const std::vector<T> &container, const T &item)
+    {
+        update(container);
+
+        const auto candidates = positions_.equal_range(style_hash()(item));
+        auto found = container.size();
+
+        for (auto candidate = candidates.first; candidate != candidates.second; ++candidate)
+        {
+            if (candidate->second < found && container[candidate->second] == item)
+            {
+                found = candidate->second;
+            }
+        }
+
+        return found;
+    }
+
+    /// <summary>
+    /// Returns the position of the first record in container equal to item,
+    /// appending item to container if there's none.
+    /// </summary>
+    std::size_t find_or_add(std::vector<T> &container, const T &item)
+    {
+        const auto found = find(container, item);
+
+        if (found == container.size())
+        {
+            container.push_back(item);
+            update(container);
+        }
+
+        return found;
+    }
+
+    void clear()
+    {
+        positions_.clear();
+        indexed_ = 0;
+    }
+
+private:
+    void update(const std::vector<T> &container)
+    {
+        if (indexed_ > container.size())
+        {
+            clear();
+        }
+
+        while (indexed_ < container.size())
+        {
+            positions_.emplace(style_hash()(container[indexed_]), indexed_);
+            ++indexed_;
+        }
+    }
+
+    std::unordered_multimap<std::size_t, std::size_t> positions_;
+    std::size_t indexed_ = 0;
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -29,6 +29,8 @@
 
 #include <detail/implementations/conditional_format_impl.hpp>
 #include <detail/implementations/format_impl.hpp>
+#include <detail/implementations/format_store.hpp>
+#include <detail/implementations/style_hash.hpp>
 #include <detail/implementations/style_impl.hpp>
 #include <xlnt/cell/cell.hpp>
 #include <xlnt/styles/conditional_format.hpp>
@@ -46,8 +48,7 @@ struct stylesheet
 {
     class format create_format(bool default_format)
     {
-		format_impls.push_back(format_impl());
-		auto &impl = format_impls.back();
+		auto &impl = format_impls.push_back(format_impl());
 
 		impl.parent = this;
 		impl.id = format_impls.size() - 1;
@@ -59,10 +60,14 @@ struct stylesheet
 
     class xlnt::format format(std::size_t index)
     {
-        auto iter = format_impls.begin();
-        std::advance(iter, static_cast<std::list<format_impl>::difference_type>(index));
+        auto impl = format_impls.at(index);
 
-        return xlnt::format(&*iter);
+        if (impl == nullptr)
+        {
+            throw invalid_parameter();
+        }
+
+        return xlnt::format(impl);
     }
 
     class style create_style(const std::string &name)
@@ -172,41 +177,99 @@ struct stylesheet
 		return id;
 	}
     
-    template<typename T, typename C>
-    std::size_t find_or_add(C &container, const T &item)
+    template<typename T>
+    std::size_t find_or_add(std::vector<T> &container, const T &item)
+    {
+        return index_of(container).find_or_add(container, item);
+    }
+
+    record_index<alignment> &index_of(std::vector<alignment> &)
+    {
+        return alignment_index;
+    }
+
+    record_index<border> &index_of(std::vector<border> &)
+    {
+        return border_index;
+    }
+
+    record_index<fill> &index_of(std::vector<fill> &)
+    {
+        return fill_index;
+    }
+
+    record_index<font> &index_of(std::vector<font> &)
+    {
+        return font_index;
+    }
+
+    record_index<number_format> &index_of(std::vector<number_format> &)
+    {
+        return number_format_index;
+    }
+
+    record_index<protection> &index_of(std::vector<protection> &)
+    {
+        return protection_index;
+    }
+
+    void clear_indexes()
+    {
+        alignment_index.clear();
+        border_index.clear();
+        fill_index.clear();
+        font_index.clear();
+        number_format_index.clear();
+        protection_index.clear();
+    }
+    
+    static void count_reference(std::vector<std::size_t> &reference_counts, const std::optional<std::size_t> &id)
     {
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wsign-conversion"
-        auto iter = std::find(container.begin(), container.end(), item);
-        if (iter != container.end())
+        if (id.has_value() && id.value() < reference_counts.size())
         {
-            return std::size_t(iter - container.begin());
+            ++reference_counts[id.value()];
         }
-        iter = container.emplace(container.end(), item);
-        return std::size_t(iter - container.begin());
-#pragma GCC diagnostic pop
     }
-    
+
+    static void remap(std::optional<std::size_t> &id, const std::vector<std::size_t> &id_map)
+    {
+        if (id.has_value())
+        {
+            id = id.value() < id_map.size() ? id_map[id.value()] : 0;
+        }
+    }
+
+    // Removes the unreferenced records of container in a single compacting
+    // pass and returns the new position of every old one.
     template<typename T>
-    std::unordered_map<std::size_t, std::size_t> garbage_collect(
-        const std::unordered_map<std::size_t, std::size_t> &reference_counts,
+    std::vector<std::size_t> garbage_collect(
+        const std::vector<std::size_t> &reference_counts,
         std::vector<T> &container)
     {
-        std::unordered_map<std::size_t, std::size_t> id_map;
-        std::size_t unreferenced = 0;
-        const auto original_size = container.size();
+        std::vector<std::size_t> id_map(container.size());
+        std::size_t kept = 0;
 
-        for (std::size_t i = 0; i < original_size; ++i)
+        for (std::size_t i = 0; i < container.size(); ++i)
         {
-            id_map[i] = i - unreferenced;
+            id_map[i] = kept;
 
-            if (reference_counts.count(i) == 0 || reference_counts.at(i) == 0)
+            if (reference_counts[i] != 0)
             {
-                container.erase(container.begin() + static_cast<typename std::vector<T>::difference_type>(i - unreferenced));
-                unreferenced++;
+                if (kept != i)
+                {
+                    container[kept] = std::move(container[i]);
+                }
+
+                ++kept;
             }
         }
 
+        if (kept != container.size())
+        {
+            container.erase(container.begin() + static_cast<typename std::vector<T>::difference_type>(kept), container.end());
+            index_of(container).clear();
+        }
+
         return id_map;
     }
     
@@ -214,134 +277,61 @@ struct stylesheet
     {
         if (!garbage_collection_enabled) return;
         
-        auto format_iter = format_impls.begin();
-        while (format_iter != format_impls.end())
-        {
-            auto &impl = *format_iter;
+        format_impls.erase_if([](const format_impl &impl) { return impl.references == 0; });
+
+        std::vector<std::size_t> alignment_reference_counts(alignments.size(), 0);
+        std::vector<std::size_t> border_reference_counts(borders.size(), 0);
+        std::vector<std::size_t> fill_reference_counts(fills.size(), 0);
+        std::vector<std::size_t> font_reference_counts(fonts.size(), 0);
+        std::vector<std::size_t> protection_reference_counts(protections.size(), 0);
+
+        // the first two fills are reserved
+        count_reference(fill_reference_counts, std::size_t(0));
+        count_reference(fill_reference_counts, std::size_t(1));
 
-            if (impl.references != 0)
-            {
-                ++format_iter;
-            }
-            else
-            {
-                format_iter = format_impls.erase(format_iter);
-            }
-        }
-        
         std::size_t new_id = 0;
 
-        std::unordered_map<std::size_t, std::size_t> alignment_reference_counts;
-        std::unordered_map<std::size_t, std::size_t> border_reference_counts;
-        std::unordered_map<std::size_t, std::size_t> fill_reference_counts;
-        std::unordered_map<std::size_t, std::size_t> font_reference_counts;
-        std::unordered_map<std::size_t, std::size_t> number_format_reference_counts;
-        std::unordered_map<std::size_t, std::size_t> protection_reference_counts;
-        
-        fill_reference_counts[0]++;
-        fill_reference_counts[1]++;
-        
         for (auto &impl : format_impls)
         {
             impl.id = new_id++;
-            
-            if (impl.alignment_id.has_value())
-            {
-                alignment_reference_counts[impl.alignment_id.value()]++;
-            }
-            
-            if (impl.border_id.has_value())
-            {
-                border_reference_counts[impl.border_id.value()]++;
-            }
-            
-            if (impl.fill_id.has_value())
-            {
-                fill_reference_counts[impl.fill_id.value()]++;
-            }
-            
-            if (impl.font_id.has_value())
-            {
-                font_reference_counts[impl.font_id.value()]++;
-            }
-            
-            if (impl.number_format_id.has_value())
-            {
-                number_format_reference_counts[impl.number_format_id.value()]++;
-            }
-            
-            if (impl.protection_id.has_value())
-            {
-                protection_reference_counts[impl.protection_id.value()]++;
-            }
+
+            count_reference(alignment_reference_counts, impl.alignment_id);
+            count_reference(border_reference_counts, impl.border_id);
+            count_reference(fill_reference_counts, impl.fill_id);
+            count_reference(font_reference_counts, impl.font_id);
+            count_reference(protection_reference_counts, impl.protection_id);
         }
         
         for (auto &name_impl_pair : style_impls)
         {
             auto &impl = name_impl_pair.second;
-            
-            if (impl.alignment_id.has_value())
-            {
-                alignment_reference_counts[impl.alignment_id.value()]++;
-            }
-            
-            if (impl.border_id.has_value())
-            {
-                border_reference_counts[impl.border_id.value()]++;
-            }
-            
-            if (impl.fill_id.has_value())
-            {
-                fill_reference_counts[impl.fill_id.value()]++;
-            }
-            
-            if (impl.font_id.has_value())
-            {
-                font_reference_counts[impl.font_id.value()]++;
-            }
-            
-            if (impl.number_format_id.has_value())
-            {
-                number_format_reference_counts[impl.number_format_id.value()]++;
-            }
-            
-            if (impl.protection_id.has_value())
-            {
-                protection_reference_counts[impl.protection_id.value()]++;
-            }
+
+            count_reference(alignment_reference_counts, impl.alignment_id);
+            count_reference(border_reference_counts, impl.border_id);
+            count_reference(fill_reference_counts, impl.fill_id);
+            count_reference(font_reference_counts, impl.font_id);
+            count_reference(protection_reference_counts, impl.protection_id);
         }
-        
-        auto alignment_id_map = garbage_collect(alignment_reference_counts, alignments);
-        auto border_id_map = garbage_collect(border_reference_counts, borders);
-        auto fill_id_map = garbage_collect(fill_reference_counts, fills);
-        auto font_id_map = garbage_collect(font_reference_counts, fonts);
-        auto protection_id_map = garbage_collect(protection_reference_counts, protections);
+
+        const auto alignment_id_map = garbage_collect(alignment_reference_counts, alignments);
+        const auto border_id_map = garbage_collect(border_reference_counts, borders);
+        const auto fill_id_map = garbage_collect(fill_reference_counts, fills);
+        const auto font_id_map = garbage_collect(font_reference_counts, fonts);
+        const auto protection_id_map = garbage_collect(protection_reference_counts, protections);
 
         for (auto &impl : format_impls)
         {
-            if (impl.alignment_id.has_value())
-            {
-                impl.alignment_id = alignment_id_map[impl.alignment_id.value()];
-            }
-            
-            if (impl.border_id.has_value())
-            {
-                impl.border_id = border_id_map[impl.border_id.value()];
-            }
-            
-            if (impl.fill_id.has_value())
-            {
-                impl.fill_id = fill_id_map[impl.fill_id.value()];
-            }
-            
-            if (impl.font_id.has_value())
-            {
-                impl.font_id = font_id_map[impl.font_id.value()];
-            }
-            
-            if (impl.protection_id.has_value())
+            auto remapped = impl;
+
+            remap(remapped.alignment_id, alignment_id_map);
+            remap(remapped.border_id, border_id_map);
+            remap(remapped.fill_id, fill_id_map);
+            remap(remapped.font_id, font_id_map);
+            remap(remapped.protection_id, protection_id_map);
+
+            if (!(remapped == impl))
             {
-                impl.protection_id = protection_id_map[impl.protection_id.value()];
+                format_impls.assign(impl, remapped);
             }
         }
 
@@ -349,48 +339,20 @@ struct stylesheet
         {
             auto &impl = name_impl.second;
 
-            if (impl.alignment_id.has_value())
-            {
-                impl.alignment_id = alignment_id_map[impl.alignment_id.value()];
-            }
-            
-            if (impl.border_id.has_value())
-            {
-                impl.border_id = border_id_map[impl.border_id.value()];
-            }
-            
-            if (impl.fill_id.has_value())
-            {
-                impl.fill_id = fill_id_map[impl.fill_id.value()];
-            }
-            
-            if (impl.font_id.has_value())
-            {
-                impl.font_id = font_id_map[impl.font_id.value()];
-            }
-            
-            if (impl.protection_id.has_value())
-            {
-                impl.protection_id = protection_id_map[impl.protection_id.value()];
-            }
+            remap(impl.alignment_id, alignment_id_map);
+            remap(impl.border_id, border_id_map);
+            remap(impl.fill_id, fill_id_map);
+            remap(impl.font_id, font_id_map);
+            remap(impl.protection_id, protection_id_map);
         }
     }
 
     format_impl *find_or_create(format_impl &pattern)
     {
         pattern.references = 0;
-        std::size_t id = 0;
-        auto iter = format_impls.begin();
-        while (iter != format_impls.end() && !(*iter == pattern))
-        {
-            ++id;
-            ++iter;
-        }
-        if (iter == format_impls.end())
-        {
-            iter = format_impls.emplace(format_impls.end(), pattern);
-        }
-        auto &result = *iter;
+        auto existing = format_impls.find(pattern);
+        const auto id = existing != nullptr ? existing->id : format_impls.size();
+        auto &result = existing != nullptr ? *existing : format_impls.push_back(pattern);
 
         result.parent = this;
         result.id = id;
@@ -398,10 +360,23 @@ struct stylesheet
         
         if (id != pattern.id)
         {
-            iter = format_impls.begin();
-            std::advance(iter, static_cast<std::list<format_impl>::difference_type>(pattern.id));
-            iter->references -= iter->references > 0 ? 1 : 0;
-            garbage_collect();
+            auto previous = format_impls.at(pattern.id);
+            if (previous != nullptr)
+            {
+                previous->references -= previous->references > 0 ? 1 : 0;
+            }
+
+            if (!garbage_collection_deferred)
+            {
+                garbage_collect();
+            }
+            else if (previous != nullptr && previous->references == 0
+                && previous->id + 1 == format_impls.size())
+            {
+                // a format that was just created and then replaced is the
+                // common case and can be dropped without renumbering anything
+                format_impls.pop_back();
+            }
         }
 
         return &result;
@@ -413,7 +388,7 @@ struct stylesheet
         new_format.style = style_name;
         if (pattern->references == 0)
         {
-            *pattern = new_format;
+            format_impls.assign(*pattern, new_format);
         }
         return find_or_create(new_format);
     }
@@ -425,7 +400,7 @@ struct stylesheet
         new_format.alignment_applied = applied;
         if (pattern->references == 0)
         {
-            *pattern = new_format;
+            format_impls.assign(*pattern, new_format);
         }
         return find_or_create(new_format);
     }
@@ -437,7 +412,7 @@ struct stylesheet
         new_format.border_applied = applied;
         if (pattern->references == 0)
         {
-            *pattern = new_format;
+            format_impls.assign(*pattern, new_format);
         }
         return find_or_create(new_format);
     }
@@ -449,7 +424,7 @@ struct stylesheet
         new_format.fill_applied = applied;
         if (pattern->references == 0)
         {
-            *pattern = new_format;
+            format_impls.assign(*pattern, new_format);
         }
         return find_or_create(new_format);
     }
@@ -461,7 +436,7 @@ struct stylesheet
         new_format.font_applied = applied;
         if (pattern->references == 0)
         {
-            *pattern = new_format;
+            format_impls.assign(*pattern, new_format);
         }
         return find_or_create(new_format);
     }
@@ -477,7 +452,7 @@ struct stylesheet
         new_format.number_format_applied = applied;
         if (pattern->references == 0)
         {
-            *pattern = new_format;
+            format_impls.assign(*pattern, new_format);
         }
         return find_or_create(new_format);
     }
@@ -489,11 +464,27 @@ struct stylesheet
         new_format.protection_applied = applied;
         if (pattern->references == 0)
         {
-            *pattern = new_format;
+            format_impls.assign(*pattern, new_format);
         }
         return find_or_create(new_format);
     }
 
+    std::size_t custom_number_format_id(const number_format &new_number_format)
+    {
+        const auto position = number_format_index.find(number_formats, new_number_format);
+
+        if (position != number_formats.size())
+        {
+            return number_formats[position].id();
+        }
+
+        auto copy = new_number_format;
+        copy.id(next_custom_number_format_id());
+        number_formats.push_back(copy);
+
+        return copy.id();
+    }
+
     std::size_t style_index(const std::string &name) const
     {
         return static_cast<std::size_t>(std::distance(style_names.begin(),
@@ -514,6 +505,7 @@ struct stylesheet
         fonts.clear();
         number_formats.clear();
         protections.clear();
+        clear_indexes();
         
         colors.clear();
     }
@@ -538,6 +530,7 @@ struct stylesheet
     {
         // no equality on parent as there is only 1 stylesheet per borkbook hence would always be false
         return garbage_collection_enabled == rhs.garbage_collection_enabled
+            && garbage_collection_deferred == rhs.garbage_collection_deferred
             && known_fonts_enabled == rhs.known_fonts_enabled
             && conditional_format_impls == rhs.conditional_format_impls
             && format_impls == rhs.format_impls
@@ -554,10 +547,11 @@ struct stylesheet
     }
     
     bool garbage_collection_enabled = true;
+    bool garbage_collection_deferred = false;
     bool known_fonts_enabled = false;
 
 	std::list<conditional_format_impl> conditional_format_impls;
-    std::list<format_impl> format_impls;
+    format_store format_impls;
     std::unordered_map<std::string, style_impl> style_impls;
     std::vector<std::string> style_names;
     std::optional<std::string> default_slicer_style;
@@ -568,6 +562,13 @@ struct stylesheet
     std::vector<font> fonts;
     std::vector<number_format> number_formats;
 	std::vector<protection> protections;
+
+    record_index<alignment> alignment_index;
+    record_index<border> border_index;
+    record_index<fill> fill_index;
+    record_index<font> font_index;
+    record_index<number_format> number_format_index;
+    record_index<protection> protection_index;
     
     std::vector<color> colors;
 };
@@ -22,11 +22,15 @@
 // @author: see AUTHORS file
 #pragma once
 
+#include <atomic>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include <detail/implementations/shared_string_table.hpp>
 #include <detail/implementations/stylesheet.hpp>
 #include <detail/implementations/worksheet_impl.hpp>
 #include <xlnt/packaging/ext_list.hpp>
@@ -43,6 +47,7 @@
 namespace xlnt {
 namespace detail {
 
+struct shared_string_source;
 struct worksheet_impl;
 
 struct workbook_impl
@@ -54,8 +59,11 @@ struct workbook_impl
     workbook_impl(const workbook_impl &other)
         : active_sheet_index_(other.active_sheet_index_),
           worksheets_(other.worksheets_),
-          shared_strings_ids_(other.shared_strings_ids_),
+          shared_strings_table_(other.shared_strings_table_),
           shared_strings_values_(other.shared_strings_values_),
+          shared_strings_source_(other.shared_strings_source_),
+          shared_strings_pending_(other.shared_strings_pending_),
+          shared_strings_lazy_(other.shared_strings_lazy_.load()),
           stylesheet_(other.stylesheet_),
           manifest_(other.manifest_),
           theme_(other.theme_),
@@ -73,8 +81,11 @@ struct workbook_impl
         active_sheet_index_ = other.active_sheet_index_;
         worksheets_.clear();
         std::copy(other.worksheets_.begin(), other.worksheets_.end(), back_inserter(worksheets_));
-        shared_strings_ids_ = other.shared_strings_ids_;
+        shared_strings_table_ = other.shared_strings_table_;
         shared_strings_values_ = other.shared_strings_values_;
+        shared_strings_source_ = other.shared_strings_source_;
+        shared_strings_pending_ = other.shared_strings_pending_;
+        shared_strings_lazy_ = other.shared_strings_lazy_.load();
         theme_ = other.theme_;
         manifest_ = other.manifest_;
 
@@ -95,7 +106,7 @@ struct workbook_impl
     {
         return active_sheet_index_ == other.active_sheet_index_
             && worksheets_ == other.worksheets_
-            && shared_strings_ids_ == other.shared_strings_ids_
+            && shared_strings_values_ == other.shared_strings_values_
             && stylesheet_ == other.stylesheet_
             && base_date_ == other.base_date_
             && title_ == other.title_
@@ -120,8 +131,18 @@ struct workbook_impl
     std::optional<std::size_t> active_sheet_index_;
 
     std::list<worksheet_impl> worksheets_;
-    std::unordered_map<rich_text, std::size_t, rich_text_hash> shared_strings_ids_;
+    shared_string_table shared_strings_table_;
     std::vector<rich_text> shared_strings_values_;
+    // set while a lazily loaded shared string table has strings which haven't been
+    // parsed yet, the pending ones being empty placeholders in shared_strings_values_
+    std::shared_ptr<const shared_string_source> shared_strings_source_;
+    std::vector<bool> shared_strings_pending_;
+    // guards the two above and the strings they fill in, since const accessors parse
+    // pending strings, so that a const workbook can still be read from several threads
+    std::mutex shared_strings_mutex_;
+    // true while shared_strings_source_ is set, so that readers only take the lock
+    // above when there may be strings left to parse
+    std::atomic<bool> shared_strings_lazy_{false};
 
     std::optional<stylesheet> stylesheet_;
 
@@ -41,6 +41,7 @@
 #include <xlnt/worksheet/print_options.hpp>
 #include <xlnt/worksheet/sheet_pr.hpp>
 #include <detail/implementations/cell_impl.hpp>
+#include <detail/implementations/cell_store.hpp>
 
 namespace xlnt {
 
@@ -91,7 +92,7 @@ struct worksheet_impl
 
         for (auto &cell : cell_map_)
         {
-            cell.second.parent_ = this;
+            cell.parent_ = this;
         }
     }
 
@@ -132,7 +133,7 @@ struct worksheet_impl
     std::unordered_map<column_t, column_properties> column_properties_;
     std::unordered_map<row_t, row_properties> row_properties_;
 
-    std::unordered_map<cell_reference, cell_impl> cell_map_;
+    cell_store cell_map_;
 
     std::optional<page_setup> page_setup_;
     std::optional<range_reference> auto_filter_;
@@ -1478,10 +1478,16 @@ std::pair<format_locale, std::string> number_format_parser::locale_from_string(c
 }
 
 number_formatter::number_formatter(const std::string &format_string, xlnt::calendar calendar)
-    : parser_(format_string), calendar_(calendar)
+    : format_(parsed_), calendar_(calendar)
+{
+    number_format_parser parser(format_string);
+    parser.parse();
+    parsed_ = parser.result();
+}
+
+number_formatter::number_formatter(const std::vector<format_code> &codes, xlnt::calendar calendar)
+    : format_(codes), calendar_(calendar)
 {
-    parser_.parse();
-    format_ = parser_.result();
 }
 
 std::string number_formatter::format_number(double number)
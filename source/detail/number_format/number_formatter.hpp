@@ -23,6 +23,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -674,10 +676,34 @@ private:
     std::vector<format_code> codes_;
 };
 
+/// <summary>
+/// The result of parsing the format string of a number_format, filled in the first
+/// time the format is used and shared by its copies so that it's only parsed once.
+/// </summary>
+struct parsed_number_format
+{
+    std::atomic<bool> parsed{false};
+    std::mutex mutex;
+    std::vector<format_code> codes;
+    bool is_date = false;
+};
+
 class XLNT_API number_formatter
 {
 public:
     number_formatter(const std::string &format_string, xlnt::calendar calendar);
+
+    /// <summary>
+    /// Formats with codes, the result of number_format_parser, which must outlive this formatter.
+    /// </summary>
+    number_formatter(const std::vector<format_code> &codes, xlnt::calendar calendar);
+
+    /// <summary>
+    /// Not copyable, since a copy would refer to the codes parsed by the original.
+    /// </summary>
+    number_formatter(const number_formatter &) = delete;
+    number_formatter &operator=(const number_formatter &) = delete;
+
     std::string format_number(double number);
     std::string format_text(const std::string &text);
 
@@ -691,8 +717,8 @@ private:
     std::string format_number(const format_code &format, double number);
     std::string format_text(const format_code &format, const std::string &text);
 
-    number_format_parser parser_;
-    std::vector<format_code> format_;
+    std::vector<format_code> parsed_;
+    const std::vector<format_code> &format_;
     xlnt::calendar calendar_;
     xlnt::detail::number_serialiser serialiser_;
 };
@@ -0,0 +1,125 @@
+// Copyright (c) 2017-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <xlnt/utils/path.hpp>
+#include <detail/serialization/mapped_file.hpp>
+
+namespace xlnt {
+namespace detail {
+
+#ifdef _WIN32
+mapped_file::mapped_file(const path &filename)
+{
+    auto file = CreateFileW(filename.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE) return;
+
+    LARGE_INTEGER file_size;
+
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
+    {
+        mapping_handle_ = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (mapping_handle_ != nullptr)
+        {
+            data_ = static_cast<const std::uint8_t *>(MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+            size_ = data_ == nullptr ? 0 : static_cast<std::size_t>(file_size.QuadPart);
+        }
+    }
+
+    // the mapping keeps its own reference to the file
+    CloseHandle(file);
+}
+
+mapped_file::~mapped_file()
+{
+    if (data_ != nullptr)
+    {
+        UnmapViewOfFile(data_);
+    }
+
+    if (mapping_handle_ != nullptr)
+    {
+        CloseHandle(mapping_handle_);
+    }
+}
+#else
+mapped_file::mapped_file(const path &filename)
+{
+    const auto file = ::open(filename.string().c_str(), O_RDONLY);
+
+    if (file == -1) return;
+
+    struct stat file_status;
+
+    if (fstat(file, &file_status) == 0 && S_ISREG(file_status.st_mode) && file_status.st_size > 0)
+    {
+        const auto size = static_cast<std::size_t>(file_status.st_size);
+        auto mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+
+        if (mapping != MAP_FAILED)
+        {
+            data_ = static_cast<const std::uint8_t *>(mapping);
+            size_ = size;
+        }
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    ::close(file);
+}
+
+mapped_file::~mapped_file()
+{
+    if (data_ != nullptr)
+    {
+        munmap(const_cast<std::uint8_t *>(data_), size_);
+    }
+}
+#endif
+
+const std::uint8_t *mapped_file::data() const
+{
+    return data_;
+}
+
+std::size_t mapped_file::size() const
+{
+    return size_;
+}
+
+} // namespace detail
+} // namespace xlnt
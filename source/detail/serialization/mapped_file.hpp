@@ -0,0 +1,77 @@
+// Copyright (c) 2017-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace xlnt {
+
+class path;
+
+namespace detail {
+
+/// <summary>
+/// A read-only memory mapping of a whole file. If the file can't be mapped,
+/// for example because it doesn't exist, is empty, or the platform has no
+/// support for mappings, data() returns nullptr and the caller is expected to
+/// fall back to reading the file through a stream.
+/// </summary>
+class mapped_file
+{
+public:
+    /// <summary>
+    /// Maps the file at filename for reading.
+    /// </summary>
+    explicit mapped_file(const path &filename);
+
+    /// <summary>
+    /// Unmaps the file. Pointers into the mapping are invalid afterwards.
+    /// </summary>
+    ~mapped_file();
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    /// <summary>
+    /// Returns the start of the mapped bytes or nullptr if the file isn't mapped.
+    /// </summary>
+    const std::uint8_t *data() const;
+
+    /// <summary>
+    /// Returns the number of mapped bytes.
+    /// </summary>
+    std::size_t size() const;
+
+private:
+    const std::uint8_t *data_ = nullptr;
+    std::size_t size_ = 0;
+#ifdef _WIN32
+    void *mapping_handle_ = nullptr;
+#endif
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -3,7 +3,10 @@
 
 #include <xlnt/cell/cell_type.hpp>
 #include <xlnt/cell/index_types.hpp>
+#include <xlnt/worksheet/row_properties.hpp>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace xlnt {
 namespace detail {
@@ -91,6 +94,13 @@ struct Cell
     std::string formula_string; // <f>
 };
 
+// <sheetData> element
+struct Sheet_Data
+{
+    std::vector<std::pair<xlnt::row_properties, xlnt::row_t>> parsed_rows;
+    std::vector<xlnt::detail::Cell> parsed_cells;
+};
+
 } // namespace detail
 } // namespace xlnt
 #endif
\ No newline at end of file
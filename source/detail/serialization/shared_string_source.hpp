@@ -0,0 +1,70 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// A shared string table part which was loaded with load_options::lazy_shared_strings.
+/// Rather than parsing every string up front, the consumer only records where
+/// each si element starts in the decompressed part.
+/// </summary>
+struct shared_string_source
+{
+    /// <summary>
+    /// The path of the part in the package, used in parser errors.
+    /// </summary>
+    std::string path;
+
+    /// <summary>
+    /// The decompressed part.
+    /// </summary>
+    std::vector<std::uint8_t> part;
+
+    /// <summary>
+    /// The root start tag, which declares the namespaces the si elements use.
+    /// </summary>
+    std::string root_start;
+
+    /// <summary>
+    /// The root end tag.
+    /// </summary>
+    std::string root_end;
+
+    /// <summary>
+    /// The byte offset of each si element in part followed by the offset just
+    /// past the last one, so string i is held in [offsets[i], offsets[i + 1]).
+    /// </summary>
+    std::vector<std::size_t> offsets;
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,969 @@
+// Copyright (c) 2016-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include <xlnt/worksheet/range_reference.hpp>
+#include <detail/serialization/sheet_data_tokenizer.hpp>
+
+namespace {
+
+// the size a ZIP archive records for a part isn't checked until the part has
+// been read, so no more than this is allocated up front on its word
+const std::size_t max_initial_part_size = std::size_t(16) << 20;
+
+bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+template <std::size_t N>
+bool equals(const char *text, std::size_t length, const char (&literal)[N])
+{
+    return length == N - 1 && std::memcmp(text, literal, N - 1) == 0;
+}
+
+template <std::size_t N>
+bool starts_with(const char *first, const char *last, const char (&literal)[N])
+{
+    return static_cast<std::size_t>(last - first) >= N - 1 && std::memcmp(first, literal, N - 1) == 0;
+}
+
+const char *find(const char *first, const char *last, char c)
+{
+    return static_cast<const char *>(std::memchr(first, c, static_cast<std::size_t>(last - first)));
+}
+
+// returns the position after the first occurrence of terminator in [first, last) or nullptr
+template <std::size_t N>
+const char *skip_past(const char *first, const char *last, const char (&terminator)[N])
+{
+    auto match = std::search(first, last, terminator, terminator + N - 1);
+    return match == last ? nullptr : match + N - 1;
+}
+
+// length of the valid UTF-8 sequence of a character allowed in XML starting at first, or 0
+std::size_t utf8_length(const char *first, const char *last)
+{
+    const auto available = last - first;
+    auto byte = [first](std::ptrdiff_t i) { return static_cast<unsigned char>(first[i]); };
+    auto continuation = [&](std::ptrdiff_t i) { return i < available && (byte(i) & 0xC0) == 0x80; };
+
+    const auto lead = byte(0);
+
+    if (lead >= 0xC2 && lead <= 0xDF)
+    {
+        return continuation(1) ? 2 : 0;
+    }
+
+    if (lead >= 0xE0 && lead <= 0xEF)
+    {
+        if (!continuation(1) || !continuation(2)) return 0;
+        if (lead == 0xE0 && byte(1) < 0xA0) return 0; // overlong
+        if (lead == 0xED && byte(1) >= 0xA0) return 0; // surrogate
+        if (lead == 0xEF && byte(1) == 0xBF && byte(2) >= 0xBE) return 0; // U+FFFE and U+FFFF
+        return 3;
+    }
+
+    if (lead >= 0xF0 && lead <= 0xF4)
+    {
+        if (!continuation(1) || !continuation(2) || !continuation(3)) return 0;
+        if (lead == 0xF0 && byte(1) < 0x90) return 0; // overlong
+        if (lead == 0xF4 && byte(1) >= 0x90) return 0; // above U+10FFFF
+        return 4;
+    }
+
+    return 0;
+}
+
+bool append_code_point(std::uint32_t code_point, std::string &out)
+{
+    const auto allowed = code_point == 0x9 || code_point == 0xA || code_point == 0xD
+        || (code_point >= 0x20 && code_point <= 0xD7FF)
+        || (code_point >= 0xE000 && code_point <= 0xFFFD)
+        || (code_point >= 0x10000 && code_point <= 0x10FFFF);
+
+    if (!allowed) return false;
+
+    if (code_point < 0x80)
+    {
+        out.push_back(static_cast<char>(code_point));
+    }
+    else if (code_point < 0x800)
+    {
+        out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+    else if (code_point < 0x10000)
+    {
+        out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+    else
+    {
+        out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+
+    return true;
+}
+
+// appends the replacement of the entity or character reference starting at first
+// and returns the position after it, or nullptr if it isn't a predefined one
+const char *append_reference(const char *first, const char *last, std::string &out)
+{
+    const auto semicolon = find(first, std::min(last, first + 12), ';');
+    if (semicolon == nullptr) return nullptr;
+
+    const auto name = first + 1;
+    const auto length = static_cast<std::size_t>(semicolon - name);
+
+    if (equals(name, length, "amp"))
+    {
+        out.push_back('&');
+    }
+    else if (equals(name, length, "lt"))
+    {
+        out.push_back('<');
+    }
+    else if (equals(name, length, "gt"))
+    {
+        out.push_back('>');
+    }
+    else if (equals(name, length, "quot"))
+    {
+        out.push_back('"');
+    }
+    else if (equals(name, length, "apos"))
+    {
+        out.push_back('\'');
+    }
+    else if (length > 1 && name[0] == '#')
+    {
+        const auto hexadecimal = name[1] == 'x';
+        auto digit = name + (hexadecimal ? 2 : 1);
+        if (digit == semicolon) return nullptr;
+
+        std::uint32_t code_point = 0;
+
+        for (; digit != semicolon; ++digit)
+        {
+            std::uint32_t value = 0;
+
+            if (*digit >= '0' && *digit <= '9')
+            {
+                value = static_cast<std::uint32_t>(*digit - '0');
+            }
+            else if (hexadecimal && *digit >= 'a' && *digit <= 'f')
+            {
+                value = static_cast<std::uint32_t>(*digit - 'a' + 10);
+            }
+            else if (hexadecimal && *digit >= 'A' && *digit <= 'F')
+            {
+                value = static_cast<std::uint32_t>(*digit - 'A' + 10);
+            }
+            else
+            {
+                return nullptr;
+            }
+
+            code_point = code_point * (hexadecimal ? 16 : 10) + value;
+            if (code_point > 0x10FFFF) return nullptr;
+        }
+
+        if (!append_code_point(code_point, out)) return nullptr;
+    }
+    else
+    {
+        return nullptr;
+    }
+
+    return semicolon + 1;
+}
+
+// Appends the character data in [first, last) to out, replacing references.
+// Fails for anything xml::parser would read differently or reject: other
+// entities, carriage returns and, in attribute values, tabs and newlines, which
+// it normalises, and characters or sequences that aren't allowed in XML.
+bool append_text(const char *first, const char *last, std::string &out, bool attribute)
+{
+    const auto text = first;
+    auto run = first;
+
+    while (first != last)
+    {
+        const auto c = static_cast<unsigned char>(*first);
+
+        if (c >= 0x20 && c < 0x80)
+        {
+            if (c == '&')
+            {
+                out.append(run, first);
+                first = append_reference(first, last, out);
+                if (first == nullptr) return false;
+                run = first;
+                continue;
+            }
+
+            if (c == '<') return false;
+            if (c == '>' && !attribute && first - text >= 2 && first[-1] == ']' && first[-2] == ']') return false;
+
+            ++first;
+        }
+        else if (c >= 0x80)
+        {
+            const auto length = utf8_length(first, last);
+            if (length == 0) return false;
+            first += length;
+        }
+        else if ((c == '\n' || c == '\t') && !attribute)
+        {
+            ++first;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    out.append(run, last);
+    return true;
+}
+
+bool parse_bool(const std::string &value, bool &result)
+{
+    if (value == "1" || value == "true")
+    {
+        result = true;
+        return true;
+    }
+
+    if (value == "0" || value == "false")
+    {
+        result = false;
+        return true;
+    }
+
+    return false;
+}
+
+template <typename T>
+bool parse_integer(const std::string &value, T &result)
+{
+    auto digit = value.begin();
+    const auto negative = std::is_signed<T>::value && digit != value.end() && *digit == '-';
+    if (negative) ++digit;
+    if (digit == value.end() || value.size() > 10) return false;
+
+    long long parsed = 0;
+
+    for (; digit != value.end(); ++digit)
+    {
+        if (*digit < '0' || *digit > '9') return false;
+        parsed = parsed * 10 + (*digit - '0');
+    }
+
+    parsed = negative ? -parsed : parsed;
+
+    if (parsed < static_cast<long long>(std::numeric_limits<T>::min())
+        || parsed > static_cast<long long>(std::numeric_limits<T>::max()))
+    {
+        return false;
+    }
+
+    result = static_cast<T>(parsed);
+    return true;
+}
+
+bool parse_cell_type(const std::string &value, xlnt::cell_type &type)
+{
+    if (value == "s")
+    {
+        type = xlnt::cell_type::shared_string;
+    }
+    else if (value == "n")
+    {
+        type = xlnt::cell_type::number;
+    }
+    else if (value == "b")
+    {
+        type = xlnt::cell_type::boolean;
+    }
+    else if (value == "e")
+    {
+        type = xlnt::cell_type::error;
+    }
+    else if (value == "inlineStr")
+    {
+        type = xlnt::cell_type::inline_string;
+    }
+    else if (value == "str")
+    {
+        type = xlnt::cell_type::formula_string;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+// only references like A1 to ZZZ1048576 are read, the row is taken from the row element
+bool is_cell_reference(const std::string &value)
+{
+    std::size_t letters = 0;
+
+    while (letters < value.size() && value[letters] >= 'A' && value[letters] <= 'Z')
+    {
+        ++letters;
+    }
+
+    if (letters == 0 || letters > 3 || letters == value.size()) return false;
+
+    return std::all_of(value.begin() + static_cast<std::ptrdiff_t>(letters), value.end(),
+        [](char c) { return c >= '0' && c <= '9'; });
+}
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+void add_parsed_row(Sheet_Data &sheet_data, std::pair<row_properties, int> &&row,
+    std::size_t first_cell, const range_reference *bounds)
+{
+    if (bounds == nullptr)
+    {
+        sheet_data.parsed_rows.push_back(std::move(row));
+        return;
+    }
+
+    const auto row_number = static_cast<row_t>(row.second);
+
+    if (row_number < bounds->top_left().row() || row_number > bounds->bottom_right().row())
+    {
+        sheet_data.parsed_cells.resize(first_cell);
+        return;
+    }
+
+    const auto first_column = bounds->top_left().column_index();
+    const auto last_column = bounds->bottom_right().column_index();
+    auto outside = std::remove_if(sheet_data.parsed_cells.begin() + static_cast<std::ptrdiff_t>(first_cell),
+        sheet_data.parsed_cells.end(), [&](const Cell &c) {
+            return c.ref.column < first_column || c.ref.column > last_column;
+        });
+    sheet_data.parsed_cells.erase(outside, sheet_data.parsed_cells.end());
+    sheet_data.parsed_rows.push_back(std::move(row));
+}
+
+sheet_data_tokenizer::sheet_data_tokenizer(const char *first, const char *last, std::string namespaces)
+    : position_(first),
+      last_(last),
+      namespaces_(std::move(namespaces))
+{
+}
+
+sheet_data_tokenizer::status sheet_data_tokenizer::read(Sheet_Data &sheet_data,
+    std::unordered_map<std::string, std::string> &array_formulae,
+    std::unordered_map<int, std::string> &shared_formulae, std::size_t max_rows, const range_reference *bounds)
+{
+    while (sheet_data.parsed_rows.size() < max_rows)
+    {
+        const auto row_start = position_;
+        const auto first_cell = sheet_data.parsed_cells.size();
+
+        if (!skip_space())
+        {
+            position_ = row_start;
+            return status::unsupported;
+        }
+
+        if (position_ == last_)
+        {
+            return status::done;
+        }
+
+        if (!read_row(sheet_data, array_formulae, shared_formulae, bounds))
+        {
+            sheet_data.parsed_cells.resize(first_cell);
+            position_ = row_start;
+            return status::unsupported;
+        }
+    }
+
+    return status::more;
+}
+
+std::string sheet_data_tokenizer::remaining_xml() const
+{
+    std::string xml = "<sheetData" + namespaces_ + ">";
+    xml.append(position_, last_);
+    xml.append("</sheetData>");
+
+    return xml;
+}
+
+bool sheet_data_tokenizer::read_row(Sheet_Data &sheet_data,
+    std::unordered_map<std::string, std::string> &array_formulae,
+    std::unordered_map<int, std::string> &shared_formulae, const range_reference *bounds)
+{
+    tag element;
+    if (!read_tag(element) || element.closing || !equals(element.name, element.length, "row")) return false;
+
+    std::pair<row_properties, int> row;
+    attribute current;
+
+    while (read_attribute(current, element))
+    {
+        if (equals(current.name, current.length, "dyDescent"))
+        {
+            row.first.dy_descent = converter_.deserialise(value_);
+        }
+        else if (equals(current.name, current.length, "spans"))
+        {
+            row.first.spans = value_;
+        }
+        else if (equals(current.name, current.length, "ht"))
+        {
+            row.first.height = converter_.deserialise(value_);
+        }
+        else if (equals(current.name, current.length, "s"))
+        {
+            std::uint32_t style = 0;
+            if (!parse_integer(value_, style)) return false;
+            row.first.style = style;
+        }
+        else if (equals(current.name, current.length, "hidden"))
+        {
+            if (!parse_bool(value_, row.first.hidden)) return false;
+        }
+        else if (equals(current.name, current.length, "customFormat"))
+        {
+            bool custom_format = false;
+            if (!parse_bool(value_, custom_format)) return false;
+            row.first.custom_format = custom_format;
+        }
+        else if (equals(current.name, current.length, "ph"))
+        {
+            bool phonetic = false;
+            if (!parse_bool(value_, phonetic)) return false;
+        }
+        else if (equals(current.name, current.length, "r"))
+        {
+            if (!parse_integer(value_, row.second)) return false;
+        }
+        else if (equals(current.name, current.length, "customHeight"))
+        {
+            if (!parse_bool(value_, row.first.custom_height)) return false;
+        }
+        else if (equals(current.name, current.length, "outlineLevel"))
+        {
+            std::uint32_t outline_level = 0;
+            if (!parse_integer(value_, outline_level)) return false;
+            row.first.outline_level = outline_level;
+        }
+    }
+
+    if (element.malformed) return false;
+
+    // like parse_row, rows below bounds are skipped without reading their cells
+    if (bounds != nullptr && static_cast<row_t>(row.second) > bounds->bottom_right().row())
+    {
+        if (element.empty) return true;
+
+        const auto end = skip_past(position_, last_, "</row");
+        if (end == nullptr) return false;
+        position_ = end - 5;
+
+        return read_tag(element) && element.closing && equals(element.name, element.length, "row");
+    }
+
+    const auto first_cell = sheet_data.parsed_cells.size();
+
+    while (!element.empty)
+    {
+        tag child;
+        if (!read_tag(child)) return false;
+
+        if (child.closing)
+        {
+            if (!equals(child.name, child.length, "row")) return false;
+            break;
+        }
+
+        if (!equals(child.name, child.length, "c")) return false;
+
+        sheet_data.parsed_cells.emplace_back();
+        if (!read_cell(child, sheet_data.parsed_cells.back(), static_cast<row_t>(row.second), array_formulae, shared_formulae))
+        {
+            return false;
+        }
+    }
+
+    add_parsed_row(sheet_data, std::move(row), first_cell, bounds);
+
+    return true;
+}
+
+bool sheet_data_tokenizer::read_cell(tag &element, Cell &cell, row_t row,
+    std::unordered_map<std::string, std::string> &array_formulae,
+    std::unordered_map<int, std::string> &shared_formulae)
+{
+    attribute current;
+
+    while (read_attribute(current, element))
+    {
+        if (equals(current.name, current.length, "r"))
+        {
+            if (!is_cell_reference(value_)) return false;
+            cell.ref = Cell_Reference(row, value_);
+        }
+        else if (equals(current.name, current.length, "t"))
+        {
+            if (!parse_cell_type(value_, cell.type)) return false;
+        }
+        else if (equals(current.name, current.length, "s"))
+        {
+            if (!parse_integer(value_, cell.style_index)) return false;
+        }
+        else if (equals(current.name, current.length, "ph"))
+        {
+            if (!parse_bool(value_, cell.is_phonetic)) return false;
+        }
+        else if (equals(current.name, current.length, "cm"))
+        {
+            if (!parse_integer(value_, cell.cell_metatdata_idx)) return false;
+        }
+    }
+
+    if (element.malformed) return false;
+
+    while (!element.empty)
+    {
+        tag child;
+        if (!read_tag(child)) return false;
+
+        if (child.closing)
+        {
+            return equals(child.name, child.length, "c");
+        }
+
+        if (equals(child.name, child.length, "v"))
+        {
+            if (!skip_attributes(child) || (!child.empty && !read_text(cell.value, "v"))) return false;
+        }
+        else if (equals(child.name, child.length, "f"))
+        {
+            if (!read_formula(child, cell, array_formulae, shared_formulae)) return false;
+        }
+        else if (equals(child.name, child.length, "is"))
+        {
+            if (!read_inline_string(child, cell)) return false;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// follows parse_cell: a shared formula without ref takes the formula of its master
+// cell and a formula with text registers it as a shared or array formula
+bool sheet_data_tokenizer::read_formula(tag &element, Cell &cell,
+    std::unordered_map<std::string, std::string> &array_formulae,
+    std::unordered_map<int, std::string> &shared_formulae)
+{
+    std::string type;
+    std::string ref;
+    auto has_type = false;
+    auto has_ref = false;
+    auto has_index = false;
+    auto index = 0;
+    attribute current;
+
+    while (read_attribute(current, element))
+    {
+        if (equals(current.name, current.length, "t"))
+        {
+            has_type = true;
+            type = value_;
+        }
+        else if (equals(current.name, current.length, "ref"))
+        {
+            has_ref = true;
+            ref = value_;
+        }
+        else if (equals(current.name, current.length, "si"))
+        {
+            has_index = parse_integer(value_, index);
+        }
+    }
+
+    if (element.malformed) return false;
+
+    if (has_type && type == "shared" && !has_ref)
+    {
+        if (!has_index) return false;
+        cell.formula_string = shared_formulae[index];
+    }
+
+    if (element.empty) return true;
+
+    const auto length = cell.formula_string.size();
+    if (!read_text(cell.formula_string, "f")) return false;
+    if (cell.formula_string.size() == length || !has_type) return true;
+
+    if (!has_ref) return false;
+
+    if (type == "shared")
+    {
+        if (!has_index) return false;
+        shared_formulae[index] = cell.formula_string;
+    }
+    else if (type == "array")
+    {
+        array_formulae[ref] = cell.formula_string;
+    }
+
+    return true;
+}
+
+// only plain text in t elements, rich text runs and phonetic properties are left to the parser
+bool sheet_data_tokenizer::read_inline_string(tag &element, Cell &cell)
+{
+    if (!skip_attributes(element)) return false;
+
+    while (!element.empty)
+    {
+        tag child;
+        if (!read_tag(child)) return false;
+
+        if (child.closing)
+        {
+            return equals(child.name, child.length, "is");
+        }
+
+        if (!equals(child.name, child.length, "t") || !skip_attributes(child)) return false;
+        if (!child.empty && !read_text(cell.value, "t")) return false;
+    }
+
+    return true;
+}
+
+template <std::size_t N>
+bool sheet_data_tokenizer::read_text(std::string &text, const char (&name)[N])
+{
+    const auto end = find(position_, last_, '<');
+    if (end == nullptr || !append_text(position_, end, text, false)) return false;
+    position_ = end;
+
+    tag closing;
+    return read_tag(closing) && closing.closing && equals(closing.name, closing.length, name);
+}
+
+bool sheet_data_tokenizer::read_tag(tag &element)
+{
+    if (!skip_space() || position_ == last_) return false;
+
+    auto p = position_ + 1;
+    element.closing = p != last_ && *p == '/';
+    if (element.closing) ++p;
+
+    element.name = p;
+    while (p != last_ && !is_space(*p) && *p != '>' && *p != '/' && *p != ':' && *p != '<')
+    {
+        ++p;
+    }
+
+    element.length = static_cast<std::size_t>(p - element.name);
+    if (element.length == 0 || p == last_ || *p == ':') return false;
+
+    position_ = p;
+    element.empty = false;
+    element.malformed = false;
+
+    if (element.closing)
+    {
+        while (position_ != last_ && is_space(*position_))
+        {
+            ++position_;
+        }
+
+        if (position_ == last_ || *position_ != '>') return false;
+        ++position_;
+    }
+
+    return true;
+}
+
+bool sheet_data_tokenizer::read_attribute(attribute &current, tag &element)
+{
+    auto p = position_;
+    const auto separated = p != last_ && is_space(*p);
+
+    while (p != last_ && is_space(*p))
+    {
+        ++p;
+    }
+
+    element.malformed = true;
+    if (p == last_) return false;
+
+    if (*p == '>' || *p == '/')
+    {
+        element.empty = *p == '/';
+        if (element.empty && (++p == last_ || *p != '>')) return false;
+
+        position_ = p + 1;
+        element.malformed = false;
+        return false;
+    }
+
+    if (!separated) return false;
+
+    const auto qualified_name = p;
+    auto local_name = p;
+
+    while (p != last_ && *p != '=' && !is_space(*p) && *p != '>' && *p != '/' && *p != '<' && *p != '"' && *p != '\'')
+    {
+        if (*p == ':') local_name = p + 1;
+        ++p;
+    }
+
+    const auto name_end = p;
+
+    if (local_name == name_end || starts_with(qualified_name, name_end, "xmlns")) return false;
+
+    while (p != last_ && is_space(*p))
+    {
+        ++p;
+    }
+
+    if (p == last_ || *p != '=') return false;
+    ++p;
+
+    while (p != last_ && is_space(*p))
+    {
+        ++p;
+    }
+
+    if (p == last_ || (*p != '"' && *p != '\'')) return false;
+
+    const auto value_end = find(p + 1, last_, *p);
+    if (value_end == nullptr) return false;
+
+    value_.clear();
+    if (!append_text(p + 1, value_end, value_, true)) return false;
+
+    position_ = value_end + 1;
+    current.name = local_name;
+    current.length = static_cast<std::size_t>(name_end - local_name);
+    element.malformed = false;
+
+    return true;
+}
+
+bool sheet_data_tokenizer::skip_attributes(tag &element)
+{
+    attribute ignored;
+    while (read_attribute(ignored, element))
+    {
+    }
+
+    return !element.malformed;
+}
+
+bool sheet_data_tokenizer::skip_space()
+{
+    while (position_ != last_ && is_space(*position_))
+    {
+        ++position_;
+    }
+
+    return position_ == last_ || *position_ == '<';
+}
+
+tokenized_worksheet::tokenized_worksheet(std::istream &part_stream, std::size_t size_hint, const std::string &part_name)
+{
+    part_.resize(std::min(std::max(size_hint, std::size_t(4096)), max_initial_part_size));
+    std::size_t used = 0;
+
+    while (true)
+    {
+        part_stream.read(part_.data() + used, static_cast<std::streamsize>(part_.size() - used));
+        used += static_cast<std::size_t>(part_stream.gcount());
+
+        if (!part_stream || part_stream.peek() == std::char_traits<char>::eof()) break;
+
+        part_.resize(part_.size() * 2);
+    }
+
+    part_.resize(used);
+
+    const char *first = part_.data();
+    const char *last = first + part_.size();
+    std::string namespaces;
+    const char *content_begin = nullptr;
+    const char *content_end = nullptr;
+    auto root = true;
+
+    for (auto p = find(first, last, '<'); p != nullptr && content_begin == nullptr; p = find(p, last, '<'))
+    {
+        if (starts_with(p, last, "<?xml "))
+        {
+            // the tokenizer only reads UTF-8
+            const auto end = skip_past(p, last, "?>");
+            if (end == nullptr) break;
+
+            const auto declaration = std::string(p, end);
+            const auto encoding = declaration.find("encoding");
+
+            if (encoding != std::string::npos)
+            {
+                auto value = declaration.substr(encoding);
+                std::transform(value.begin(), value.end(), value.begin(), [](char c) {
+                    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                });
+
+                if (value.find("utf-8") == std::string::npos) break;
+            }
+
+            p = end;
+        }
+        else if (starts_with(p, last, "<?"))
+        {
+            p = skip_past(p, last, "?>");
+        }
+        else if (starts_with(p, last, "<!--"))
+        {
+            p = skip_past(p, last, "-->");
+        }
+        else if (starts_with(p, last, "<![CDATA["))
+        {
+            p = skip_past(p, last, "]]>");
+        }
+        else if (starts_with(p, last, "<!"))
+        {
+            // a DOCTYPE could declare entities
+            break;
+        }
+        else if (root)
+        {
+            // the namespace declarations of the root element, which are in scope in sheetData
+            root = false;
+            auto q = p + 1;
+
+            while (q != last && *q != '>')
+            {
+                if (*q == '"' || *q == '\'')
+                {
+                    q = find(q + 1, last, *q);
+                    if (q == nullptr) break;
+                    ++q;
+                }
+                else if (is_space(*q) && starts_with(q + 1, last, "xmlns"))
+                {
+                    const auto declaration = q;
+                    const auto equals_sign = find(q, last, '=');
+                    if (equals_sign == nullptr) break;
+
+                    q = equals_sign + 1;
+                    while (q != last && is_space(*q)) ++q;
+                    if (q == last || (*q != '"' && *q != '\'')) break;
+
+                    q = find(q + 1, last, *q);
+                    if (q == nullptr) break;
+                    ++q;
+
+                    namespaces.append(declaration, q);
+                }
+                else
+                {
+                    ++q;
+                }
+            }
+
+            if (q == nullptr || q == last) break;
+            p = q;
+        }
+        else if (starts_with(p, last, "<sheetData>"))
+        {
+            content_begin = p + 11;
+        }
+        else
+        {
+            ++p;
+        }
+
+        if (p == nullptr) break;
+    }
+
+    // sheetData ends at the first end tag which closes it, as long as there's no markup
+    // in between, like comments or CDATA sections, in which it could also appear
+    for (auto p = content_begin == nullptr ? nullptr : find(content_begin, last, '<');
+         p != nullptr; p = find(p + 1, last, '<'))
+    {
+        if (starts_with(p, last, "<!") || starts_with(p, last, "<?")) break;
+
+        if (starts_with(p, last, "</sheetData>"))
+        {
+            content_end = p;
+            break;
+        }
+    }
+
+    if (content_end == nullptr || content_end == content_begin)
+    {
+        parser_.reset(new xml::parser(part_.data(), part_.size(), part_name));
+        return;
+    }
+
+    outside_sheet_data_.assign(first, content_begin);
+    outside_sheet_data_.insert(outside_sheet_data_.end(), content_end, last);
+    parser_.reset(new xml::parser(outside_sheet_data_.data(), outside_sheet_data_.size(), part_name));
+    tokenizer_.reset(new sheet_data_tokenizer(content_begin, content_end, std::move(namespaces)));
+}
+
+xml::parser &tokenized_worksheet::parser()
+{
+    return *parser_;
+}
+
+sheet_data_tokenizer *tokenized_worksheet::tokenizer()
+{
+    return tokenizer_.get();
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,185 @@
+// Copyright (c) 2016-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <xlnt/utils/numeric.hpp>
+#include <detail/external/include_libstudxml.hpp>
+#include <detail/serialization/serialisation_helpers.hpp>
+
+namespace xlnt {
+
+class range_reference;
+
+namespace detail {
+
+/// <summary>
+/// Appends row, whose cells have just been appended to sheet_data from first_cell
+/// on, to sheet_data. If bounds isn't null, a row outside it is dropped along with
+/// its cells and only the cells of other rows which are inside it are kept.
+/// </summary>
+void add_parsed_row(Sheet_Data &sheet_data, std::pair<row_properties, int> &&row,
+    std::size_t first_cell, const range_reference *bounds);
+
+/// <summary>
+/// Reads the rows and cells of a sheetData element straight from its XML
+/// rather than through xml::parser, producing the same Sheet_Data. Only the
+/// markup worksheets are normally written with is recognised: row and c
+/// elements with v, f and is/t children, the predefined entities and character
+/// references. At the first row holding anything else, reading stops so that
+/// the rest can be handed to xml::parser, which also reports malformed XML.
+/// Text is scanned for markup with memchr, which C libraries vectorise.
+/// </summary>
+class sheet_data_tokenizer
+{
+public:
+    enum class status
+    {
+        more,
+        done,
+        unsupported
+    };
+
+    /// <summary>
+    /// Reads the content of a sheetData element, [first, last), which must not hold
+    /// comments, CDATA sections or processing instructions. namespaces are the
+    /// namespace declarations in scope, written as attributes.
+    /// </summary>
+    sheet_data_tokenizer(const char *first, const char *last, std::string namespaces);
+
+    /// <summary>
+    /// Appends rows to sheet_data, as parse_sheet_data does, until it holds max_rows
+    /// rows or the content ends, which returns more or done. Returns unsupported,
+    /// leaving sheet_data without any part of the row, at a row which can't be read.
+    /// </summary>
+    status read(Sheet_Data &sheet_data, std::unordered_map<std::string, std::string> &array_formulae,
+        std::unordered_map<int, std::string> &shared_formulae, std::size_t max_rows, const range_reference *bounds);
+
+    /// <summary>
+    /// Returns a sheetData element holding the rows which haven't been read yet,
+    /// declaring the namespaces given on construction, for parsing with xml::parser.
+    /// </summary>
+    std::string remaining_xml() const;
+
+private:
+    struct tag
+    {
+        const char *name;
+        std::size_t length;
+        bool closing;
+        bool empty;
+        bool malformed;
+    };
+
+    struct attribute
+    {
+        const char *name;
+        std::size_t length;
+    };
+
+    bool read_row(Sheet_Data &sheet_data, std::unordered_map<std::string, std::string> &array_formulae,
+        std::unordered_map<int, std::string> &shared_formulae, const range_reference *bounds);
+    bool read_cell(tag &element, Cell &cell, row_t row, std::unordered_map<std::string, std::string> &array_formulae,
+        std::unordered_map<int, std::string> &shared_formulae);
+    bool read_formula(tag &element, Cell &cell, std::unordered_map<std::string, std::string> &array_formulae,
+        std::unordered_map<int, std::string> &shared_formulae);
+    bool read_inline_string(tag &element, Cell &cell);
+
+    /// <summary>
+    /// Appends the text up to the next tag to text and reads that tag, which must end name.
+    /// </summary>
+    template <std::size_t N>
+    bool read_text(std::string &text, const char (&name)[N]);
+
+    /// <summary>
+    /// Reads the name of the start or end tag after any whitespace. The attributes
+    /// of a start tag are then read with read_attribute until it returns false.
+    /// </summary>
+    bool read_tag(tag &element);
+
+    /// <summary>
+    /// Reads the next attribute of element, leaving its local name in current and
+    /// its value in value_. Returns false after the end of the start tag, setting
+    /// element.empty, or setting element.malformed if it couldn't be read.
+    /// </summary>
+    bool read_attribute(attribute &current, tag &element);
+    bool skip_attributes(tag &element);
+
+    /// <summary>
+    /// Skips whitespace, returning false if there's other text before the next tag.
+    /// </summary>
+    bool skip_space();
+
+    const char *position_;
+    const char *last_;
+    std::string namespaces_;
+    std::string value_;
+    number_serialiser converter_;
+};
+
+/// <summary>
+/// The XML of a worksheet part held in memory, split so that its sheetData content
+/// can be read by a sheet_data_tokenizer and everything else by an xml::parser.
+/// If the part holds a DOCTYPE, or markup inside sheetData that can't be told
+/// apart from rows by looking for tags, or sheetData is empty or has attributes,
+/// the parser reads the whole part and there's no tokenizer.
+/// </summary>
+class tokenized_worksheet
+{
+public:
+    /// <summary>
+    /// Reads all of part_stream, which is expected to hold about size_hint bytes.
+    /// The buffer starts out no larger than a fixed bound and grows as needed, so
+    /// a size_hint taken from a damaged archive can't allocate far beyond the part.
+    /// </summary>
+    tokenized_worksheet(std::istream &part_stream, std::size_t size_hint, const std::string &part_name);
+
+    tokenized_worksheet(const tokenized_worksheet &) = delete;
+    tokenized_worksheet &operator=(const tokenized_worksheet &) = delete;
+
+    xml::parser &parser();
+
+    /// <summary>
+    /// Returns the tokenizer for the content of sheetData or nullptr.
+    /// </summary>
+    sheet_data_tokenizer *tokenizer();
+
+private:
+    std::vector<char> part_;
+    std::vector<char> outside_sheet_data_;
+    std::unique_ptr<xml::parser> parser_;
+    std::unique_ptr<sheet_data_tokenizer> tokenizer_;
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,66 @@
+// Copyright (c) 2016-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <xlnt/utils/exceptions.hpp>
+#include <detail/serialization/sheet_data_writer.hpp>
+
+namespace xlnt {
+namespace detail {
+
+sheet_data_writer::sheet_data_writer(std::streambuf &destination)
+    : destination_(destination)
+{
+}
+
+void sheet_data_writer::reference(column_t::index_t column, row_t row)
+{
+    char letters[3];
+    auto first = letters + sizeof(letters);
+
+    while (column > 0 && first != letters)
+    {
+        --column;
+        *--first = static_cast<char>('A' + column % 26);
+        column /= 26;
+    }
+
+    write(first, static_cast<std::size_t>(letters + sizeof(letters) - first));
+    integer(row);
+}
+
+void sheet_data_writer::flush()
+{
+    if (used_ == 0) return;
+
+    const auto length = static_cast<std::streamsize>(used_);
+    used_ = 0;
+
+    if (destination_.sputn(buffer_, length) != length)
+    {
+        throw xlnt::exception("failed to write sheet data");
+    }
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,117 @@
+// Copyright (c) 2016-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <streambuf>
+
+#include <xlnt/cell/index_types.hpp>
+#include <xlnt/utils/numeric.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Writes the markup of sheetData rows and cells straight into the streambuf
+/// of a part, bypassing xml::serializer. Only text that needs no escaping is
+/// accepted: literal markup, integers, doubles and cell references. Output is
+/// collected in a fixed buffer, so nothing is allocated, and must be flushed
+/// before the serializer writes to the same part again.
+/// </summary>
+class sheet_data_writer
+{
+public:
+    explicit sheet_data_writer(std::streambuf &destination);
+
+    sheet_data_writer(const sheet_data_writer &) = delete;
+    sheet_data_writer &operator=(const sheet_data_writer &) = delete;
+
+    /// <summary>
+    /// Appends markup given as a string literal, e.g. "<row r=\"".
+    /// </summary>
+    template <std::size_t N>
+    void literal(const char (&text)[N])
+    {
+        write(text, N - 1);
+    }
+
+    /// <summary>
+    /// Appends the decimal representation of value.
+    /// </summary>
+    void integer(std::uint64_t value)
+    {
+        char digits[20];
+        auto first = digits + sizeof(digits);
+
+        do
+        {
+            *--first = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+
+        write(first, static_cast<std::size_t>(digits + sizeof(digits) - first));
+    }
+
+    /// <summary>
+    /// Appends value formatted like number_serialiser::serialise.
+    /// </summary>
+    void number(double value)
+    {
+        char text[30];
+        write(text, converter_.serialise(value, text));
+    }
+
+    /// <summary>
+    /// Appends a cell reference like "AB12".
+    /// </summary>
+    void reference(column_t::index_t column, row_t row);
+
+    /// <summary>
+    /// Passes everything appended so far on to the streambuf.
+    /// </summary>
+    void flush();
+
+private:
+    void write(const char *text, std::size_t length)
+    {
+        if (length > sizeof(buffer_) - used_)
+        {
+            flush();
+        }
+
+        std::memcpy(buffer_ + used_, text, length);
+        used_ += length;
+    }
+
+    std::streambuf &destination_;
+    number_serialiser converter_;
+    char buffer_[4096];
+    std::size_t used_ = 0;
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -120,6 +120,41 @@ std::streampos vector_istreambuf::seekpos(std::streampos sp, std::ios_base::open
     return static_cast<std::ptrdiff_t>(position_);
 }
 
+memory_istreambuf::memory_istreambuf(const std::uint8_t *data, std::size_t size)
+{
+    // the get area is never written through, it's only typed as char *
+    auto begin = const_cast<char *>(reinterpret_cast<const char *>(data));
+    setg(begin, begin, begin + size);
+}
+
+std::streampos memory_istreambuf::seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode)
+{
+    auto position = off;
+
+    if (way == std::ios_base::cur)
+    {
+        position += gptr() - eback();
+    }
+    else if (way == std::ios_base::end)
+    {
+        position += egptr() - eback();
+    }
+
+    if (position < 0 || position > egptr() - eback())
+    {
+        return static_cast<std::ptrdiff_t>(-1);
+    }
+
+    setg(eback(), eback() + position, egptr());
+
+    return static_cast<std::ptrdiff_t>(position);
+}
+
+std::streampos memory_istreambuf::seekpos(std::streampos sp, std::ios_base::openmode which)
+{
+    return seekoff(static_cast<std::streamoff>(sp), std::ios_base::beg, which);
+}
+
 vector_ostreambuf::vector_ostreambuf(std::vector<std::uint8_t> &data)
     : data_(data),
       position_(0)
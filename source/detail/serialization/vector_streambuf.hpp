@@ -61,6 +61,24 @@ private:
     std::size_t position_;
 };
 
+/// <summary>
+/// Allows a contiguous block of memory that outlives it, such as a memory mapped
+/// file, to be read through a std::istream without copying the block first.
+/// </summary>
+class XLNT_API memory_istreambuf : public std::streambuf
+{
+public:
+    memory_istreambuf(const std::uint8_t *data, std::size_t size);
+
+    memory_istreambuf(const memory_istreambuf &) = delete;
+    memory_istreambuf &operator=(const memory_istreambuf &) = delete;
+
+private:
+    std::streampos seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode) override;
+
+    std::streampos seekpos(std::streampos sp, std::ios_base::openmode) override;
+};
+
 /// <summary>
 /// Allows a std::vector to be written through a std::ostream.
 /// </summary>
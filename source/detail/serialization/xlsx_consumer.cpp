@@ -22,9 +22,17 @@
 // @author: see AUTHORS file
 
 #include <cassert>
+#include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <mutex>
 #include <numeric> // for std::accumulate
 #include <sstream>
+#include <thread>
 #include <unordered_map>
 
 #include <xlnt/cell/cell.hpp>
@@ -43,6 +51,8 @@
 #include <detail/serialization/custom_value_traits.hpp>
 #include <detail/serialization/defined_name.hpp>
 #include <detail/serialization/serialisation_helpers.hpp>
+#include <detail/serialization/shared_string_source.hpp>
+#include <detail/serialization/sheet_data_tokenizer.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/xlsx_consumer.hpp>
 #include <detail/serialization/zstream.hpp>
@@ -78,7 +88,8 @@ inline bool string_equal(const std::string &lhs, const char (&rhs)[N])
 xml::qname &qn(const std::string &namespace_, const std::string &name)
 {
     using qname_map = std::unordered_map<std::string, xml::qname>;
-    static auto memo = std::unordered_map<std::string, qname_map>();
+    // one memo per thread since worksheets may be read concurrently
+    thread_local auto memo = std::unordered_map<std::string, qname_map>();
 
     auto &ns_memo = memo[namespace_];
 
@@ -130,13 +141,6 @@ void set_style_by_xfid(const std::vector<style_id_pair> &styles,
     }
 }
 
-// <sheetData> element
-struct Sheet_Data
-{
-    std::vector<std::pair<xlnt::row_properties, xlnt::row_t>> parsed_rows;
-    std::vector<xlnt::detail::Cell> parsed_cells;
-};
-
 xlnt::cell_type type_from_string(const std::string &str)
 {
     if (string_equal(str, "s"))
@@ -166,9 +170,18 @@ xlnt::cell_type type_from_string(const std::string &str)
     return xlnt::cell::type::shared_string;
 }
 
-xlnt::detail::Cell parse_cell(xlnt::row_t row_arg, xml::parser *parser, std::unordered_map<std::string, std::string> &array_formulae, std::unordered_map<int, std::string> &shared_formulae)
+// <c> inside <row> element
+// c is overwritten rather than replaced so that the streaming reader can reuse its string buffers
+void parse_cell(xlnt::row_t row_arg, xml::parser *parser, xlnt::detail::Cell &c, std::unordered_map<std::string, std::string> &array_formulae, std::unordered_map<int, std::string> &shared_formulae)
 {
-    xlnt::detail::Cell c;
+    c.is_phonetic = false;
+    c.type = xlnt::cell_type::number;
+    c.cell_metatdata_idx = -1;
+    c.style_index = -1;
+    c.ref = xlnt::detail::Cell_Reference(0, 0);
+    c.value.clear();
+    c.formula_string.clear();
+
     for (auto &attr : parser->attribute_map())
     {
         if (string_equal(attr.first.name(), "r"))
@@ -273,11 +286,10 @@ xlnt::detail::Cell parse_cell(xlnt::row_t row_arg, xml::parser *parser, std::uno
         // Prevents unhandled exceptions from being triggered.
         parser->attribute_map();
     }
-    return c;
 }
 
-// <row> inside <sheetData> element
-std::pair<xlnt::row_properties, int> parse_row(xml::parser *parser, xlnt::detail::number_serialiser &converter, std::vector<xlnt::detail::Cell> &parsed_cells, std::unordered_map<std::string, std::string> &array_formulae, std::unordered_map<int, std::string> &shared_formulae)
+// attributes of a <row> element, the row's children are left for the caller
+std::pair<xlnt::row_properties, int> parse_row_attributes(xml::parser *parser, xlnt::detail::number_serialiser &converter)
 {
     std::pair<xlnt::row_properties, int> props;
     for (auto &attr : parser->attribute_map())
@@ -324,6 +336,48 @@ std::pair<xlnt::row_properties, int> parse_row(xml::parser *parser, xlnt::detail
         }
     }
 
+    return props;
+}
+
+// consumes the remainder of the element whose start was just read, ignoring its attributes
+void skip_element(xml::parser *parser)
+{
+    parser->attribute_map();
+
+    int level = 1;
+    while (level > 0)
+    {
+        switch (parser->next())
+        {
+        case xml::parser::start_element: {
+            ++level;
+            break;
+        }
+        case xml::parser::end_element: {
+            --level;
+            break;
+        }
+        default: {
+            break;
+        }
+        }
+        parser->attribute_map();
+    }
+}
+
+// <row> inside <sheetData> element
+// rows below bounds aren't parsed at all, the cells of other rows are parsed and the caller drops
+// those outside bounds, so that shared formulae they define are still available to the rest
+std::pair<xlnt::row_properties, int> parse_row(xml::parser *parser, xlnt::detail::number_serialiser &converter, std::vector<xlnt::detail::Cell> &parsed_cells, std::unordered_map<std::string, std::string> &array_formulae, std::unordered_map<int, std::string> &shared_formulae, const xlnt::range_reference *bounds)
+{
+    auto props = parse_row_attributes(parser, converter);
+
+    if (bounds != nullptr && static_cast<xlnt::row_t>(props.second) > bounds->bottom_right().row())
+    {
+        skip_element(parser);
+        return props;
+    }
+
     int level = 1;
     while (level > 0)
     {
@@ -331,7 +385,8 @@ std::pair<xlnt::row_properties, int> parse_row(xml::parser *parser, xlnt::detail
         switch (e)
         {
         case xml::parser::start_element: {
-            parsed_cells.push_back(parse_cell(static_cast<xlnt::row_t>(props.second), parser, array_formulae, shared_formulae));
+            parsed_cells.emplace_back();
+            parse_cell(static_cast<xlnt::row_t>(props.second), parser, parsed_cells.back(), array_formulae, shared_formulae);
             break;
         }
         case xml::parser::end_element: {
@@ -356,25 +411,25 @@ std::pair<xlnt::row_properties, int> parse_row(xml::parser *parser, xlnt::detail
 }
 
 // <sheetData> inside <worksheet> element
-Sheet_Data parse_sheet_data(xml::parser *parser, xlnt::detail::number_serialiser &converter, std::unordered_map<std::string, std::string> &array_formulae, std::unordered_map<int, std::string> &shared_formulae)
+// parses at most max_rows rows into sheet_data and returns true once </sheetData> has been consumed
+// if bounds isn't null, only the rows and cells inside it are kept and count towards max_rows
+bool parse_sheet_data(xml::parser *parser, xlnt::detail::number_serialiser &converter, xlnt::detail::Sheet_Data &sheet_data, std::unordered_map<std::string, std::string> &array_formulae, std::unordered_map<int, std::string> &shared_formulae, std::size_t max_rows, const xlnt::range_reference *bounds)
 {
-    Sheet_Data sheet_data;
-    int level = 1; // nesting level
-        // 1 == <sheetData>
-        // 2 == <row>
-
-    while (level > 0)
+    // <row> is the only child of <sheetData> so the next end element closes <sheetData>
+    while (sheet_data.parsed_rows.size() < max_rows)
     {
         xml::parser::event_type e = parser->next();
         switch (e)
         {
         case xml::parser::start_element: {
-            sheet_data.parsed_rows.push_back(parse_row(parser, converter, sheet_data.parsed_cells, array_formulae, shared_formulae));
+            const auto first_cell = sheet_data.parsed_cells.size();
+            auto row = parse_row(parser, converter, sheet_data.parsed_cells, array_formulae, shared_formulae, bounds);
+
+            xlnt::detail::add_parsed_row(sheet_data, std::move(row), first_cell, bounds);
             break;
         }
         case xml::parser::end_element: {
-            --level;
-            break;
+            return true;
         }
         case xml::parser::characters: {
             // ignore, whitespace formatting normally
@@ -390,7 +445,240 @@ Sheet_Data parse_sheet_data(xml::parser *parser, xlnt::detail::number_serialiser
         }
         }
     }
-    return sheet_data;
+    return false;
+}
+
+/// <summary>
+/// Bounded single producer, single consumer queue used to hand chunks of parsed
+/// sheetData from the parsing thread to the thread building the cells.
+/// </summary>
+class sheet_data_queue
+{
+public:
+    explicit sheet_data_queue(std::size_t capacity)
+        : capacity_(capacity)
+    {
+    }
+
+    /// <summary>
+    /// Blocks while the queue is full. Returns false if the consumer gave up.
+    /// </summary>
+    bool push(xlnt::detail::Sheet_Data &&chunk)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this]() { return aborted_ || chunks_.size() < capacity_; });
+
+        if (aborted_)
+        {
+            return false;
+        }
+
+        chunks_.push_back(std::move(chunk));
+        not_empty_.notify_one();
+
+        return true;
+    }
+
+    /// <summary>
+    /// Blocks while the queue is empty. Returns false once the queue has been
+    /// closed and drained.
+    /// </summary>
+    bool pop(xlnt::detail::Sheet_Data &chunk)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this]() { return closed_ || !chunks_.empty(); });
+
+        if (chunks_.empty())
+        {
+            return false;
+        }
+
+        chunk = std::move(chunks_.front());
+        chunks_.pop_front();
+        not_full_.notify_one();
+
+        return true;
+    }
+
+    /// <summary>
+    /// Called by the producer when no more chunks will be pushed.
+    /// </summary>
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_one();
+    }
+
+    /// <summary>
+    /// Called by the consumer to release a producer waiting on a full queue.
+    /// </summary>
+    void abort()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        aborted_ = true;
+        not_full_.notify_one();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::deque<xlnt::detail::Sheet_Data> chunks_;
+    std::size_t capacity_;
+    bool closed_ = false;
+    bool aborted_ = false;
+};
+
+/// <summary>
+/// Returns the position just past the markup starting with the '<' at begin, which
+/// may be a tag, a comment, a CDATA section or a processing instruction.
+/// </summary>
+std::size_t skip_markup(const char *data, std::size_t size, std::size_t begin)
+{
+    auto starts_with = [&](const std::string &prefix) {
+        return size - begin >= prefix.size() && std::equal(prefix.begin(), prefix.end(), data + begin);
+    };
+
+    auto skip_past = [&](const std::string &terminator) {
+        auto found = std::search(data + begin, data + size, terminator.begin(), terminator.end());
+
+        if (found == data + size)
+        {
+            throw xlnt::invalid_file("unterminated markup in shared string table");
+        }
+
+        return static_cast<std::size_t>(found - data) + terminator.size();
+    };
+
+    if (starts_with("<!--")) return skip_past("-->");
+    if (starts_with("<![CDATA[")) return skip_past("]]>");
+    if (starts_with("<?")) return skip_past("?>");
+
+    // attribute values may contain '>'
+    char quote = 0;
+
+    for (auto i = begin + 1; i < size; ++i)
+    {
+        const auto c = data[i];
+
+        if (quote != 0)
+        {
+            if (c == quote) quote = 0;
+        }
+        else if (c == '"' || c == '\'')
+        {
+            quote = c;
+        }
+        else if (c == '>')
+        {
+            return i + 1;
+        }
+    }
+
+    throw xlnt::invalid_file("unterminated markup in shared string table");
+}
+
+/// <summary>
+/// Returns true if the tag starting at data[begin] has the local name "si".
+/// </summary>
+bool is_string_item(const char *data, std::size_t begin, std::size_t end)
+{
+    auto name_end = begin + 1;
+
+    while (name_end < end && !std::isspace(static_cast<unsigned char>(data[name_end]))
+        && data[name_end] != '/' && data[name_end] != '>')
+    {
+        ++name_end;
+    }
+
+    const auto name = std::string(data + begin + 1, data + name_end);
+    const auto colon = name.find(':');
+
+    return (colon == std::string::npos ? name : name.substr(colon + 1)) == "si";
+}
+
+/// <summary>
+/// Fills in the root tags and string offsets of source from its part. This only
+/// tracks tag nesting; the strings are checked by the XML parser when they're read.
+/// </summary>
+void scan_shared_string_table(xlnt::detail::shared_string_source &source)
+{
+    const auto data = reinterpret_cast<const char *>(source.part.data());
+    const auto size = source.part.size();
+
+    std::size_t position = 0;
+    std::size_t depth = 0;
+    std::size_t last_string_end = 0;
+    bool in_string = false;
+
+    while (true)
+    {
+        const auto found = std::find(data + position, data + size, '<');
+
+        if (found == data + size)
+        {
+            throw xlnt::invalid_file("missing end of shared string table");
+        }
+
+        const auto begin = static_cast<std::size_t>(found - data);
+        const auto end = skip_markup(data, size, begin);
+        position = end;
+
+        const auto kind = begin + 1 < size ? data[begin + 1] : '\0';
+
+        if (kind == '!' || kind == '?')
+        {
+            continue;
+        }
+
+        if (kind == '/')
+        {
+            if (--depth == 0)
+            {
+                source.root_end.assign(data + begin, data + end);
+                break;
+            }
+
+            if (depth == 1 && in_string)
+            {
+                last_string_end = end;
+            }
+
+            continue;
+        }
+
+        const auto self_closing = data[end - 2] == '/';
+
+        if (depth == 0)
+        {
+            source.root_start.assign(data + begin, data + end);
+            if (self_closing) break;
+            depth = 1;
+            continue;
+        }
+
+        if (depth == 1)
+        {
+            in_string = is_string_item(data, begin, end);
+
+            if (in_string)
+            {
+                source.offsets.push_back(begin);
+                if (self_closing) last_string_end = end;
+            }
+        }
+
+        if (!self_closing)
+        {
+            ++depth;
+        }
+    }
+
+    if (!source.offsets.empty())
+    {
+        source.offsets.push_back(last_string_end);
+    }
 }
 
 } // namespace
@@ -416,11 +704,52 @@ namespace xlnt {
 namespace detail {
 
 xlsx_consumer::xlsx_consumer(workbook &target)
+    : xlsx_consumer(target, load_options())
+{
+}
+
+xlsx_consumer::xlsx_consumer(workbook &target, const load_options &options)
     : target_(target),
-      parser_(nullptr)
+      parser_(nullptr),
+      options_(options)
 {
 }
 
+std::unique_lock<std::mutex> xlsx_consumer::lock_workbook()
+{
+    if (workbook_mutex_ == nullptr)
+    {
+        return std::unique_lock<std::mutex>();
+    }
+
+    return std::unique_lock<std::mutex>(*workbook_mutex_);
+}
+
+void xlsx_consumer::drop_merged_formulae(const range_reference &reference)
+{
+    const auto top_left = reference.top_left();
+    const auto bottom_right = reference.bottom_right();
+
+    for (auto row = top_left.row(); row <= bottom_right.row(); ++row)
+    {
+        for (auto column = top_left.column(); column <= bottom_right.column(); ++column)
+        {
+            if (row == top_left.row() && column == top_left.column())
+            {
+                continue;
+            }
+
+            auto cell = current_worksheet_->cell_map_.find(cell_reference(column, row));
+
+            if (cell != nullptr && cell->formula().has_value())
+            {
+                cell->formula(std::nullopt);
+                merged_formulae_dropped_ = true;
+            }
+        }
+    }
+}
+
 xlsx_consumer::~xlsx_consumer()
 {
 }
@@ -431,12 +760,24 @@ void xlsx_consumer::read(std::istream &source)
     populate_workbook(false);
 }
 
+void xlsx_consumer::read(const std::uint8_t *data, std::size_t size)
+{
+    archive_.reset(new izstream(data, size));
+    populate_workbook(false);
+}
+
 void xlsx_consumer::open(std::istream &source)
 {
     archive_.reset(new izstream(source));
     populate_workbook(true);
 }
 
+void xlsx_consumer::open(const std::uint8_t *data, std::size_t size)
+{
+    archive_.reset(new izstream(data, size));
+    populate_workbook(true);
+}
+
 cell xlsx_consumer::read_cell()
 {
     return cell(streaming_cell_.get());
@@ -523,6 +864,8 @@ std::string xlsx_consumer::read_worksheet_begin(const std::string &rel_id)
     {
         streaming_cell_.reset(new detail::cell_impl());
     }
+
+    streaming_in_row_ = false;
     
     array_formulae_.clear();
     shared_formulae_.clear();
@@ -650,6 +993,7 @@ std::string xlsx_consumer::read_worksheet_begin(const std::string &rel_id)
                 if (parser().attribute_present("tabSelected")
                     && is_true(parser().attribute("tabSelected")))
                 {
+                    auto lock = lock_workbook();
                     target_.d_->view_.value().active_tab = ws.id() - 1;
                 }
 
@@ -842,80 +1186,210 @@ void xlsx_consumer::read_worksheet_sheetdata()
         return;
     }
 
-    auto ws_data = parse_sheet_data(parser_, converter_, array_formulae_, shared_formulae_);
-    // NOTE: parse->construct are seperated here and could easily be threaded
-    // with a SPSC queue for what is likely to be an easy performance win
-    for (auto &row : ws_data.parsed_rows)
+    const auto range = options_.sheet_ranges.find(current_worksheet_->title_);
+    const auto bounds = range == options_.sheet_ranges.end() ? nullptr : &range->second;
+
+    if (options_.pipeline_sheet_data)
     {
-        current_worksheet_->row_properties_.emplace(row.second, std::move(row.first));
+        read_worksheet_sheetdata_pipelined(bounds);
     }
-    auto impl = detail::cell_impl();
-    for (Cell &cell : ws_data.parsed_cells)
+    else
     {
-        impl.parent_ = current_worksheet_;
-        impl.column_ = cell.ref.column;
-        impl.row_ = cell.ref.row;
-        detail::cell_impl *ws_cell_impl = &current_worksheet_->cell_map_.emplace(cell_reference(impl.column_, impl.row_), std::move(impl)).first->second;
-        if (cell.style_index != -1)
+        Sheet_Data ws_data;
+        while (!read_sheet_data_rows(ws_data, std::numeric_limits<std::size_t>::max(), bounds))
         {
-            ws_cell_impl->format_ = target_.format(static_cast<size_t>(cell.style_index)).d_;
         }
-        if (cell.cell_metatdata_idx != -1)
+        build_worksheet_sheetdata(ws_data);
+    }
+
+    stack_.pop_back();
+}
+
+void xlsx_consumer::read_worksheet_sheetdata_pipelined(const range_reference *bounds)
+{
+    // a few chunks in flight is enough to keep both threads busy without
+    // holding much more of the sheet in memory than the cells themselves
+    const auto chunk_rows = std::max(options_.sheet_data_chunk_rows, std::size_t(1));
+    sheet_data_queue queue(4);
+    std::exception_ptr build_error;
+
+    std::thread builder([this, &queue, &build_error]() {
+        try
         {
+            Sheet_Data chunk;
+
+            while (queue.pop(chunk))
+            {
+                build_worksheet_sheetdata(chunk);
+            }
         }
-        ws_cell_impl->phonetics_visible_ = cell.is_phonetic;
-        if (!cell.formula_string.empty())
+        catch (...)
         {
-            ws_cell_impl->formula_ = cell.formula_string[0] == '=' ? cell.formula_string.substr(1) : std::move(cell.formula_string);
+            build_error = std::current_exception();
+            queue.abort();
         }
-        if (!cell.value.empty())
+    });
+
+    try
+    {
+        auto done = false;
+
+        while (!done)
         {
-            ws_cell_impl->type_ = cell.type;
-            switch (cell.type)
+            Sheet_Data chunk;
+            done = read_sheet_data_rows(chunk, chunk_rows, bounds);
+
+            if (!queue.push(std::move(chunk)))
             {
-            case cell::type::boolean: {
-                ws_cell_impl->value_numeric_ = is_true(cell.value) ? 1.0 : 0.0;
-                break;
-            }
-            case cell::type::empty:
-            case cell::type::number:
-            case cell::type::date: {
-                ws_cell_impl->value_numeric_ = converter_.deserialise(cell.value);
                 break;
             }
-            case cell::type::shared_string: {
-                ws_cell_impl->value_numeric_ = static_cast<double>(strtol(cell.value.c_str(), nullptr, 10));
-                break;
-            }
-            case cell::type::inline_string: {
-                ws_cell_impl->value_text_ = std::make_shared<xlnt::rich_text>(std::move(cell.value));
-                break;
-            }
-            case cell::type::formula_string: {
-                ws_cell_impl->value_text_ = std::make_shared<xlnt::rich_text>(std::move(cell.value));
-                break;
-            }
-            case cell::type::error: {
-                ws_cell_impl->value_text_ = std::make_shared<xlnt::rich_text>();
-                ws_cell_impl->value_text_->plain_text(cell.value, false);
-                break;
-            }
-            }
         }
     }
+    catch (...)
+    {
+        queue.close();
+        builder.join();
+        throw;
+    }
 
-    stack_.pop_back();
+    queue.close();
+    builder.join();
+
+    if (build_error)
+    {
+        std::rethrow_exception(build_error);
+    }
+}
+
+bool xlsx_consumer::read_sheet_data_rows(Sheet_Data &sheet_data, std::size_t max_rows, const range_reference *bounds)
+{
+    if (sheet_data_tokenizer_ != nullptr)
+    {
+        const auto status = sheet_data_tokenizer_->read(sheet_data, array_formulae_, shared_formulae_, max_rows, bounds);
+
+        if (status == sheet_data_tokenizer::status::more)
+        {
+            return false;
+        }
+
+        if (status == sheet_data_tokenizer::status::unsupported)
+        {
+            sheet_data_fallback_xml_ = sheet_data_tokenizer_->remaining_xml();
+            sheet_data_fallback_parser_.reset(new xml::parser(sheet_data_fallback_xml_.data(),
+                sheet_data_fallback_xml_.size(), parser_->input_name()));
+            sheet_data_fallback_parser_->next(); // <sheetData>
+        }
+
+        sheet_data_tokenizer_ = nullptr;
+    }
+
+    if (sheet_data_fallback_parser_)
+    {
+        if (!parse_sheet_data(sheet_data_fallback_parser_.get(), converter_, sheet_data, array_formulae_, shared_formulae_, max_rows, bounds))
+        {
+            return false;
+        }
+
+        sheet_data_fallback_parser_.reset();
+        sheet_data_fallback_xml_.clear();
+    }
+
+    // parser_ is left with the end of sheetData or, without a tokenizer, all of its rows
+    return parse_sheet_data(parser_, converter_, sheet_data, array_formulae_, shared_formulae_, max_rows, bounds);
+}
+
+void xlsx_consumer::build_worksheet_sheetdata(Sheet_Data &sheet_data)
+{
+    for (auto &row : sheet_data.parsed_rows)
+    {
+        current_worksheet_->row_properties_.emplace(row.second, std::move(row.first));
+    }
+    auto impl = detail::cell_impl();
+    for (Cell &cell : sheet_data.parsed_cells)
+    {
+        impl.parent_ = current_worksheet_;
+        impl.column_ = cell.ref.column;
+        impl.row_ = cell.ref.row;
+        detail::cell_impl *ws_cell_impl = current_worksheet_->cell_map_.emplace(std::move(impl)).first;
+        assign_parsed_cell(cell, *ws_cell_impl);
+    }
+
+}
+
+void xlsx_consumer::assign_parsed_cell(Cell &cell, detail::cell_impl &target)
+{
+    if (cell.style_index != -1)
+    {
+        // attached directly, reference counts only matter when formats are changed afterwards
+        target.format_ = target_.format(static_cast<size_t>(cell.style_index)).d_;
+    }
+    if (cell.cell_metatdata_idx != -1)
+    {
+    }
+    target.phonetics_visible_ = cell.is_phonetic;
+    if (!cell.formula_string.empty())
+    {
+        target.formula(cell.formula_string[0] == '=' ? cell.formula_string.substr(1) : std::move(cell.formula_string));
+    }
+    if (!cell.value.empty())
+    {
+        // through the store so that its shared string count includes loaded cells
+        target.parent_->cell_map_.set_type(target, cell.type);
+        switch (cell.type)
+        {
+        case cell::type::boolean: {
+            target.value_numeric_ = is_true(cell.value) ? 1.0 : 0.0;
+            break;
+        }
+        case cell::type::empty:
+        case cell::type::number:
+        case cell::type::date: {
+            target.value_numeric_ = converter_.deserialise(cell.value);
+            break;
+        }
+        case cell::type::shared_string: {
+            target.value_numeric_ = static_cast<double>(strtol(cell.value.c_str(), nullptr, 10));
+            break;
+        }
+        case cell::type::inline_string: {
+            target.value_text(std::make_shared<xlnt::rich_text>(std::move(cell.value)));
+            break;
+        }
+        case cell::type::formula_string: {
+            target.value_text(std::make_shared<xlnt::rich_text>(std::move(cell.value)));
+            break;
+        }
+        case cell::type::error: {
+            auto text = std::make_shared<xlnt::rich_text>();
+            text->plain_text(cell.value, false);
+            target.value_text(std::move(text));
+            break;
+        }
+        }
+    }
 }
 
 worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
+{
+    read_worksheet_trailing_elements(worksheet_hyperlinks(rel_id));
+    read_worksheet_related_parts(rel_id);
+
+    return worksheet(current_worksheet_);
+}
+
+std::vector<relationship> xlsx_consumer::worksheet_hyperlinks(const std::string &rel_id)
 {
     auto &manifest = target_.manifest();
 
     const auto workbook_rel = manifest.relationship(path("/"), relationship_type::office_document);
     const auto sheet_rel = manifest.relationship(workbook_rel.target().path(), rel_id);
     path sheet_path(sheet_rel.source().path().parent().append(sheet_rel.target().path()));
-    auto hyperlinks = manifest.relationships(sheet_path, xlnt::relationship_type::hyperlink);
 
+    return manifest.relationships(sheet_path, xlnt::relationship_type::hyperlink);
+}
+
+void xlsx_consumer::read_worksheet_trailing_elements(const std::vector<relationship> &hyperlinks)
+{
     auto ws = worksheet(current_worksheet_);
 
     while (in_element(qn("spreadsheetml", "worksheet")))
@@ -960,10 +1434,20 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
         {
             parser().attribute_map();
 
+            // merging clears the cells under the merge, which may add a shared string
+            auto lock = lock_workbook();
+
             while (in_element(qn("spreadsheetml", "mergeCells")))
             {
                 expect_start_element(qn("spreadsheetml", "mergeCell"), xml::content::simple);
-                ws.merge_cells(range_reference(parser().attribute("ref")));
+                const auto reference = range_reference(parser().attribute("ref"));
+
+                if (workbook_mutex_ != nullptr)
+                {
+                    drop_merged_formulae(reference);
+                }
+
+                ws.merge_cells(reference);
                 expect_end_element(qn("spreadsheetml", "mergeCell"));
             }
         }
@@ -990,6 +1474,9 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
         }
         else if (current_worksheet_element == qn("spreadsheetml", "hyperlinks")) // CT_Hyperlinks 0-1
         {
+            // hyperlinks may register relationships and shared strings
+            auto lock = lock_workbook();
+
             while (in_element(current_worksheet_element))
             {
                 // CT_Hyperlink
@@ -1035,7 +1522,7 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
                         hyperlink->tooltip = parser().attribute("tooltip");
                     }
 
-                    cell.d_->hyperlink_ = hyperlink;
+                    cell.d_->hyperlink(hyperlink);
                 }
 
                 expect_end_element(qn("spreadsheetml", "hyperlink"));
@@ -1307,6 +1794,39 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
 
     expect_end_element(qn("spreadsheetml", "worksheet"));
 
+    if (!array_formulae_.empty())
+    {
+        // setting a formula registers the calculation chain in the manifest
+        auto lock = lock_workbook();
+
+        for (auto array_formula : array_formulae_)
+        {
+            for (auto row : ws.range(array_formula.first))
+            {
+                for (auto cell : row)
+                {
+                    cell.formula(array_formula.second);
+                }
+            }
+        }
+    }
+}
+
+void xlsx_consumer::read_worksheet_related_parts(const std::string &rel_id)
+{
+    if (options_.values_only)
+    {
+        return;
+    }
+
+    auto &manifest = target_.manifest();
+
+    const auto workbook_rel = manifest.relationship(path("/"), relationship_type::office_document);
+    const auto sheet_rel = manifest.relationship(workbook_rel.target().path(), rel_id);
+    path sheet_path(sheet_rel.source().path().parent().append(sheet_rel.target().path()));
+
+    auto ws = worksheet(current_worksheet_);
+
     if (manifest.has_relationship(sheet_path, xlnt::relationship_type::comments))
     {
         auto comments_part = manifest.canonicalize({workbook_rel, sheet_rel,
@@ -1343,249 +1863,77 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
         auto drawings_part_streambuf = archive_->open(drawings_part);
         std::istream drawings_part_stream(drawings_part_streambuf.get());
         xml::parser parser(drawings_part_stream, drawings_part.string(), receive);
-        parser_ = &parser;
-
-        read_drawings(ws, drawings_part);
-    }
-
-    if (manifest.has_relationship(sheet_path, xlnt::relationship_type::printer_settings))
-    {
-        read_part({workbook_rel, sheet_rel,
-            manifest.relationship(sheet_path,
-                relationship_type::printer_settings)});
-    }
-    
-    for (auto array_formula : array_formulae_)
-    {
-        for (auto row : ws.range(array_formula.first))
-        {
-            for (auto cell : row)
-            {
-                cell.formula(array_formula.second);
-            }
-        }
-    }
-
-    return ws;
-}
-
-xml::parser &xlsx_consumer::parser()
-{
-    return *parser_;
-}
-
-bool xlsx_consumer::has_cell()
-{
-    auto ws = worksheet(current_worksheet_);
-
-    while (streaming_cell_ // we're not at the end of the file
-           && !in_element(qn("spreadsheetml", "row"))) // we're at the end of a row, or between rows
-    {
-        if (parser().peek() == xml::parser::event_type::end_element
-            && stack_.back() == qn("spreadsheetml", "row"))
-        {
-            // We're at the end of a row.
-            expect_end_element(qn("spreadsheetml", "row"));
-            // ... and keep parsing.
-        }
-
-        if (parser().peek() == xml::parser::event_type::end_element
-            && stack_.back() == qn("spreadsheetml", "sheetData"))
-        {
-            // End of sheet. Mark it by setting streaming_cell_ to nullptr, so we never get here again.
-            expect_end_element(qn("spreadsheetml", "sheetData"));
-            streaming_cell_.reset(nullptr);
-            break;
-        }
-
-        expect_start_element(qn("spreadsheetml", "row"), xml::content::complex); // CT_Row
-        auto row_index = static_cast<row_t>(std::stoul(parser().attribute("r")));
-        auto &row_properties = ws.row_properties(row_index);
-
-        if (parser().attribute_present("ht"))
-        {
-            row_properties.height = converter_.deserialise(parser().attribute("ht"));
-        }
-
-        if (parser().attribute_present("customHeight"))
-        {
-            row_properties.custom_height = is_true(parser().attribute("customHeight"));
-        }
-
-        if (parser().attribute_present("hidden") && is_true(parser().attribute("hidden")))
-        {
-            row_properties.hidden = true;
-        }
-
-        if (parser().attribute_present(qn("x14ac", "dyDescent")))
-        {
-            row_properties.dy_descent = converter_.deserialise(parser().attribute(qn("x14ac", "dyDescent")));
-        }
-
-        if (parser().attribute_present("spans"))
-        {
-            row_properties.spans = parser().attribute("spans");
-        }
-
-        if (parser().attribute_present("outlineLevel"))
-        {
-            row_properties.outline_level = parser().attribute<std::size_t>("outlineLevel");
-        }
-
-        skip_attributes({"customFormat", "s", "customFont",
-            "collapsed", "thickTop", "thickBot",
-            "ph"});
-    }
-
-    if (!streaming_cell_)
-    {
-        // We're at the end of the worksheet
-        return false;
-    }
-
-    expect_start_element(qn("spreadsheetml", "c"), xml::content::complex);
-
-    assert(streaming_);
-    streaming_cell_.reset(new detail::cell_impl()); // Clean cell state - otherwise it might contain information from the previously streamed cell.
-    auto cell = xlnt::cell(streaming_cell_.get());
-    auto reference = cell_reference(parser().attribute("r"));
-    cell.d_->parent_ = current_worksheet_;
-    cell.d_->column_ = reference.column_index();
-    cell.d_->row_ = reference.row();
-
-    if (parser().attribute_present("ph"))
-    {
-        cell.d_->phonetics_visible_ = parser().attribute<bool>("ph");
-    }
-
-    auto has_type = parser().attribute_present("t");
-    auto type = has_type ? parser().attribute("t") : "n";
-
-    if (parser().attribute_present("s"))
-    {
-        cell.format(target_.format(static_cast<std::size_t>(std::stoull(parser().attribute("s")))));
-    }
-
-    auto has_value = false;
-    auto value_string = std::string();
-    auto formula_string = std::string();
-
-    while (in_element(qn("spreadsheetml", "c")))
-    {
-        auto current_element = expect_start_element(xml::content::mixed);
-
-        if (current_element == qn("spreadsheetml", "v")) // s:ST_Xstring
-        {
-            has_value = true;
-            value_string = read_text();
-        }
-        else if (current_element == qn("spreadsheetml", "f")) // CT_CellFormula
-        {
-            auto has_shared_formula = false;
-            auto has_array_formula = false;
-            auto is_master_cell = false;
-            auto shared_formula_index = 0;
-            auto formula_range = range_reference();
-
-            if (parser().attribute_present("t"))
-            {
-                auto formula_type = parser().attribute("t");
-                if (formula_type == "shared")
-                {
-                    has_shared_formula = true;
-                    shared_formula_index = parser().attribute<int>("si");
-                    if (parser().attribute_present("ref"))
-                    {
-                        is_master_cell = true;
-                    }
-                }
-                else if (formula_type == "array")
-                {
-                    has_array_formula = true;
-                    formula_range = range_reference(parser().attribute("ref"));
-                    is_master_cell = true;
-                }
-            }
-
-            skip_attributes({"aca", "dt2D", "dtr", "del1", "del2", "r1",
-                "r2", "ca", "bx"});
-
-            formula_string = read_text();
-            
-            if (is_master_cell)
-            {
-                if (has_shared_formula)
-                {
-                    shared_formulae_[shared_formula_index] = formula_string;
-                }
-                else if (has_array_formula)
-                {
-                    array_formulae_[formula_range.to_string()] = formula_string;
-                }
-            }
-            else if (has_shared_formula)
-            {
-                auto shared_formula = shared_formulae_.find(shared_formula_index);
-                if (shared_formula != shared_formulae_.end())
-                {
-                    formula_string = shared_formula->second;
-                }
-            }
-        }
-        else if (current_element == qn("spreadsheetml", "is")) // CT_Rst
-        {
-            expect_start_element(qn("spreadsheetml", "t"), xml::content::simple);
-            has_value = true;
-            value_string = read_text();
-            expect_end_element(qn("spreadsheetml", "t"));
-        }
-        else
-        {
-            unexpected_element(current_element);
-        }
+        parser_ = &parser;
 
-        expect_end_element(current_element);
+        read_drawings(ws, drawings_part);
     }
 
-    expect_end_element(qn("spreadsheetml", "c"));
-
-    if (!formula_string.empty())
+    if (manifest.has_relationship(sheet_path, xlnt::relationship_type::printer_settings))
     {
-        cell.formula(formula_string);
+        read_part({workbook_rel, sheet_rel,
+            manifest.relationship(sheet_path,
+                relationship_type::printer_settings)});
     }
+}
+
+xml::parser &xlsx_consumer::parser()
+{
+    return *parser_;
+}
 
-    if (has_value)
+bool xlsx_consumer::has_cell()
+{
+    // Rows and cells are read straight from the parser, as in read_worksheet_sheetdata,
+    // and every cell is parsed into the same objects, so reading a numeric or
+    // shared string cell doesn't allocate.
+    while (streaming_cell_) // we're not at the end of the sheet
     {
-        if (type == "str")
+        switch (parser_->next())
         {
-            cell.d_->value_text_ = std::make_shared<xlnt::rich_text>(value_string);
-            cell.data_type(cell::type::formula_string);
-        }
-        else if (type == "inlineStr")
-        {
-            cell.d_->value_text_ = std::make_shared<xlnt::rich_text>(value_string);
-            cell.data_type(cell::type::inline_string);
+        case xml::parser::start_element: {
+            if (!streaming_in_row_)
+            {
+                auto row = parse_row_attributes(parser_, converter_);
+                streaming_row_ = static_cast<row_t>(row.second);
+                streaming_in_row_ = true;
+                current_worksheet_->row_properties_.emplace(streaming_row_, std::move(row.first));
+                break;
+            }
+
+            parse_cell(streaming_row_, parser_, streaming_parsed_cell_, array_formulae_, shared_formulae_);
+
+            // clean cell state, otherwise it might contain information from the previously streamed cell
+            *streaming_cell_ = detail::cell_impl();
+            streaming_cell_->parent_ = current_worksheet_;
+            streaming_cell_->column_ = streaming_parsed_cell_.ref.column;
+            streaming_cell_->row_ = streaming_parsed_cell_.ref.row;
+            assign_parsed_cell(streaming_parsed_cell_, *streaming_cell_);
+
+            return true;
         }
-        else if (type == "s")
-        {
-            cell.d_->value_numeric_ = converter_.deserialise(value_string);
-            cell.data_type(cell::type::shared_string);
+        case xml::parser::end_element: {
+            if (streaming_in_row_)
+            {
+                streaming_in_row_ = false;
+                break;
+            }
+
+            // End of sheet. Mark it by setting streaming_cell_ to nullptr, so we never get here again.
+            stack_.pop_back();
+            streaming_cell_.reset(nullptr);
+            break;
         }
-        else if (type == "b") // boolean
-        {
-            cell.value(is_true(value_string));
+        case xml::parser::characters: {
+            // ignore, whitespace formatting normally
+            break;
         }
-        else if (type == "n") // numeric
-        {
-            cell.value(converter_.deserialise(value_string));
+        default: {
+            throw xlnt::exception("unexcpected XML parsing event");
         }
-        else if (!value_string.empty() && value_string[0] == '#')
-        {
-            cell.error(value_string);
         }
     }
 
-    return true;
+    return false;
 }
 
 std::vector<relationship> xlsx_consumer::read_relationships(const path &part)
@@ -1681,7 +2029,14 @@ void xlsx_consumer::read_part(const std::vector<relationship> &rel_chain)
         break;
 
     case relationship_type::shared_string_table:
-        read_shared_string_table();
+        if (options_.lazy_shared_strings)
+        {
+            index_shared_string_table(part_stream, part_path);
+        }
+        else
+        {
+            read_shared_string_table();
+        }
         break;
 
     case relationship_type::stylesheet:
@@ -1701,7 +2056,19 @@ void xlsx_consumer::read_part(const std::vector<relationship> &rel_chain)
         break;
 
     case relationship_type::worksheet:
-        read_worksheet(rel_chain.back().id());
+        // the streaming reader keeps reading sheetData from parser_ after this returns
+        if (options_.tokenize_sheet_data && !streaming_)
+        {
+            tokenized_worksheet worksheet_part(part_stream, archive_->uncompressed_size(part_path), part_path.string());
+            parser_ = &worksheet_part.parser();
+            sheet_data_tokenizer_ = worksheet_part.tokenizer();
+            read_worksheet(rel_chain.back().id());
+            sheet_data_tokenizer_ = nullptr;
+        }
+        else
+        {
+            read_worksheet(rel_chain.back().id());
+        }
         break;
 
     case relationship_type::thumbnail:
@@ -1792,6 +2159,12 @@ void xlsx_consumer::populate_workbook(bool streaming)
             continue;
         }
 
+        if (options_.values_only)
+        {
+            // document properties and the thumbnail
+            continue;
+        }
+
         read_part({package_rel});
     }
 
@@ -2198,6 +2571,11 @@ void xlsx_consumer::read_office_document(const std::string &content_type) // CT_
 
     for (auto rel_type : rel_types)
     {
+        if (options_.values_only && (rel_type == relationship_type::theme || rel_type == relationship_type::vbaproject))
+        {
+            continue;
+        }
+
         if (manifest().has_relationship(workbook_path, rel_type))
         {
             read_part({workbook_rel,
@@ -2205,13 +2583,27 @@ void xlsx_consumer::read_office_document(const std::string &content_type) // CT_
         }
     }
 
-    for (auto worksheet_rel : manifest().relationships(workbook_path, relationship_type::worksheet))
-    {
-        auto title = std::find_if(target_.d_->sheet_title_rel_id_map_.begin(),
+    const auto worksheet_rels = manifest().relationships(workbook_path, relationship_type::worksheet);
+    auto worksheet_threads = options_.worksheet_threads == 0
+        ? static_cast<std::size_t>(std::thread::hardware_concurrency())
+        : options_.worksheet_threads;
+    worksheet_threads = std::min(worksheet_threads, worksheet_rels.size());
+    std::vector<std::pair<relationship, worksheet_impl *>> deferred_worksheets;
+
+    auto worksheet_title = [&](const relationship &worksheet_rel) {
+        return std::find_if(target_.d_->sheet_title_rel_id_map_.begin(),
             target_.d_->sheet_title_rel_id_map_.end(),
             [&](const std::pair<std::string, std::string> &p) {
                 return p.second == worksheet_rel.id();
             })->first;
+    };
+
+    const auto selected_titles = selected_worksheets(worksheet_rels, worksheet_title);
+    std::vector<worksheet_impl *> unselected_worksheets;
+
+    for (auto worksheet_rel : worksheet_rels)
+    {
+        auto title = worksheet_title(worksheet_rel);
 
         auto id = sheet_title_id_map_[title];
         auto index = sheet_title_index_map_[title];
@@ -2225,11 +2617,233 @@ void xlsx_consumer::read_office_document(const std::string &content_type) // CT_
 
         current_worksheet_ = &*target_.d_->worksheets_.emplace(insertion_iter, &target_, id, title);
 
-        if (!streaming_)
+        if (streaming_)
+        {
+            continue;
+        }
+
+        if (!selected_titles.empty() && selected_titles.count(title) == 0)
+        {
+            unselected_worksheets.push_back(current_worksheet_);
+            continue;
+        }
+
+        if (worksheet_threads > 1)
+        {
+            deferred_worksheets.emplace_back(worksheet_rel, current_worksheet_);
+        }
+        else
         {
             read_part({workbook_rel, worksheet_rel});
         }
     }
+
+    if (!deferred_worksheets.empty())
+    {
+        read_worksheets_concurrently(workbook_rel, deferred_worksheets, worksheet_threads);
+    }
+
+    remove_worksheets(unselected_worksheets);
+}
+
+std::unordered_set<std::string> xlsx_consumer::selected_worksheets(const std::vector<relationship> &worksheet_rels,
+    const std::function<std::string(const relationship &)> &worksheet_title)
+{
+    std::unordered_set<std::string> selected;
+
+    if (options_.sheet_titles.empty() && options_.sheet_indices.empty())
+    {
+        return selected;
+    }
+
+    // indices are positions among the worksheets, as in workbook::sheet_by_index,
+    // while sheet_title_index_map_ also counts chartsheets
+    std::vector<std::string> titles;
+
+    for (const auto &worksheet_rel : worksheet_rels)
+    {
+        titles.push_back(worksheet_title(worksheet_rel));
+    }
+
+    std::sort(titles.begin(), titles.end(), [this](const std::string &a, const std::string &b) {
+        return sheet_title_index_map_[a] < sheet_title_index_map_[b];
+    });
+
+    for (const auto &title : options_.sheet_titles)
+    {
+        if (std::find(titles.begin(), titles.end(), title) == titles.end())
+        {
+            throw key_not_found();
+        }
+
+        selected.insert(title);
+    }
+
+    for (auto index : options_.sheet_indices)
+    {
+        if (index >= titles.size())
+        {
+            throw invalid_parameter();
+        }
+
+        selected.insert(titles[index]);
+    }
+
+    return selected;
+}
+
+void xlsx_consumer::remove_worksheets(const std::vector<worksheet_impl *> &worksheets)
+{
+    if (worksheets.empty()) return;
+
+    auto &sheets = target_.d_->worksheets_;
+    auto active = sheets.begin();
+    std::advance(active, std::min(target_.d_->active_sheet_index_.value_or(0), sheets.size() - 1));
+    const auto active_impl = &*active;
+
+    for (auto impl : worksheets)
+    {
+        target_.remove_sheet(worksheet(impl));
+    }
+
+    // keep the same worksheet active if it was loaded
+    std::size_t active_index = 0;
+
+    for (auto iter = sheets.begin(); iter != sheets.end(); ++iter)
+    {
+        if (&*iter == active_impl)
+        {
+            active_index = static_cast<std::size_t>(std::distance(sheets.begin(), iter));
+        }
+    }
+
+    if (!sheets.empty())
+    {
+        target_.active_sheet(active_index);
+    }
+}
+
+void xlsx_consumer::read_worksheets_concurrently(const relationship &workbook_rel,
+    const std::vector<std::pair<relationship, worksheet_impl *>> &worksheets, std::size_t thread_count)
+{
+    // a stream backed archive reads from a single stream, so the compressed parts
+    // are copied out here and each worker only inflates and parses its own copy.
+    // A memory backed archive can be opened from every worker directly.
+    std::vector<path> part_paths;
+    std::vector<std::vector<std::uint8_t>> stored_parts;
+
+    // workers register relationships while they read, so the manifest is only
+    // read here, before any of them start
+    std::vector<std::vector<relationship>> hyperlinks;
+
+    for (const auto &worksheet : worksheets)
+    {
+        part_paths.push_back(manifest().canonicalize({workbook_rel, worksheet.first}));
+        hyperlinks.push_back(worksheet_hyperlinks(worksheet.first.id()));
+
+        if (!archive_->memory_backed())
+        {
+            stored_parts.push_back(archive_->read_stored(part_paths.back()));
+        }
+    }
+
+    std::mutex workbook_mutex;
+    std::atomic<std::size_t> next_worksheet(0);
+    std::atomic<bool> merged_formulae_dropped(false);
+    std::vector<std::exception_ptr> errors(worksheets.size());
+
+    auto read_worksheets = [&]() {
+        for (auto i = next_worksheet++; i < worksheets.size(); i = next_worksheet++)
+        {
+            try
+            {
+                std::unique_ptr<std::streambuf> stored_buffer;
+                std::unique_ptr<std::istream> stored_stream;
+                std::unique_ptr<std::streambuf> part_streambuf;
+
+                if (archive_->memory_backed())
+                {
+                    part_streambuf = archive_->open(part_paths[i]);
+                }
+                else
+                {
+                    stored_buffer.reset(new vector_istreambuf(stored_parts[i]));
+                    stored_stream.reset(new std::istream(stored_buffer.get()));
+                    part_streambuf = archive_->open_stored(part_paths[i], *stored_stream);
+                }
+
+                std::istream part_stream(part_streambuf.get());
+                std::unique_ptr<tokenized_worksheet> worksheet_part;
+                std::unique_ptr<xml::parser> parser;
+
+                xlsx_consumer worksheet_consumer(target_, options_);
+
+                if (options_.tokenize_sheet_data)
+                {
+                    worksheet_part.reset(new tokenized_worksheet(part_stream,
+                        archive_->uncompressed_size(part_paths[i]), part_paths[i].string()));
+                    worksheet_consumer.parser_ = &worksheet_part->parser();
+                    worksheet_consumer.sheet_data_tokenizer_ = worksheet_part->tokenizer();
+                }
+                else
+                {
+                    parser.reset(new xml::parser(part_stream, part_paths[i].string()));
+                    worksheet_consumer.parser_ = parser.get();
+                }
+                worksheet_consumer.workbook_mutex_ = &workbook_mutex;
+                worksheet_consumer.current_worksheet_ = worksheets[i].second;
+                worksheet_consumer.defined_names_ = defined_names_;
+
+                const auto &rel_id = worksheets[i].first.id();
+                worksheet_consumer.read_worksheet_begin(rel_id);
+                worksheet_consumer.read_worksheet_sheetdata();
+                worksheet_consumer.read_worksheet_trailing_elements(hyperlinks[i]);
+
+                if (worksheet_consumer.merged_formulae_dropped_)
+                {
+                    merged_formulae_dropped = true;
+                }
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+
+    for (std::size_t i = 1; i < thread_count; ++i)
+    {
+        workers.emplace_back(read_worksheets);
+    }
+
+    read_worksheets();
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    for (const auto &error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    if (merged_formulae_dropped)
+    {
+        target_.garbage_collect_formulae();
+    }
+
+    // comments, drawings and printer settings are read through the shared archive
+    for (const auto &worksheet : worksheets)
+    {
+        current_worksheet_ = worksheet.second;
+        read_worksheet_related_parts(worksheet.first.id());
+    }
 }
 
 // Write Workbook Relationship Target Parts
@@ -2296,6 +2910,134 @@ void xlsx_consumer::read_shared_string_table()
     }
 }
 
+void xlsx_consumer::index_shared_string_table(std::istream &part_stream, const path &part_path)
+{
+    auto source = std::make_shared<shared_string_source>();
+    source->path = part_path.string();
+    source->part = to_vector(part_stream);
+    scan_shared_string_table(*source);
+
+    // the root element is parsed on its own to check it and its unique count
+    const auto root = source->root_start + source->root_end;
+    xml::parser parser(root.data(), root.size(), source->path);
+    parser_ = &parser;
+
+    expect_start_element(qn("spreadsheetml", "sst"), xml::content::complex);
+    skip_attributes({"count"});
+
+    const auto count = source->offsets.empty() ? std::size_t(0) : source->offsets.size() - 1;
+
+    if (parser.attribute_present("uniqueCount") && parser.attribute<std::size_t>("uniqueCount") != count)
+    {
+        throw invalid_file("sizes don't match");
+    }
+
+    expect_end_element(qn("spreadsheetml", "sst"));
+    parser_ = nullptr;
+
+    if (count == 0) return;
+
+    target_.register_workbook_part(relationship_type::shared_string_table);
+
+    auto &impl = target_.impl();
+    impl.shared_strings_values_.resize(count);
+    impl.shared_strings_pending_.assign(count, true);
+    impl.shared_strings_source_ = std::move(source);
+    impl.shared_strings_lazy_ = true;
+}
+
+void xlsx_consumer::read_shared_string(std::size_t index)
+{
+    auto &impl = target_.impl();
+    const auto &source = *impl.shared_strings_source_;
+    const auto part = reinterpret_cast<const char *>(source.part.data());
+
+    auto text = source.root_start;
+    text.append(part + source.offsets[index], part + source.offsets[index + 1]);
+    text.append(source.root_end);
+
+    xml::parser parser(text.data(), text.size(), source.path);
+    parser_ = &parser;
+
+    expect_start_element(qn("spreadsheetml", "sst"), xml::content::complex);
+    skip_attributes();
+    expect_start_element(qn("spreadsheetml", "si"), xml::content::complex);
+    impl.shared_strings_values_[index] = read_rich_text(qn("spreadsheetml", "si"));
+    expect_end_element(qn("spreadsheetml", "si"));
+    expect_end_element(qn("spreadsheetml", "sst"));
+
+    parser_ = nullptr;
+    impl.shared_strings_pending_[index] = false;
+}
+
+void xlsx_consumer::read_shared_strings()
+{
+    auto &impl = target_.impl();
+    const auto source = impl.shared_strings_source_;
+    const auto part = reinterpret_cast<const char *>(source->part.data());
+    auto &values = impl.shared_strings_values_;
+    auto &pending = impl.shared_strings_pending_;
+
+    // strings already read through read_shared_string are left out, the rest
+    // are parsed as one document, adjacent ones copied as a single range
+    auto text = source->root_start;
+    std::size_t index = 0;
+
+    while (index < values.size())
+    {
+        if (!pending[index])
+        {
+            ++index;
+            continue;
+        }
+
+        auto last = index;
+
+        while (last < values.size() && pending[last])
+        {
+            ++last;
+        }
+
+        text.append(part + source->offsets[index], part + source->offsets[last]);
+        index = last;
+    }
+
+    text.append(source->root_end);
+
+    xml::parser parser(text.data(), text.size(), source->path);
+    parser_ = &parser;
+
+    expect_start_element(qn("spreadsheetml", "sst"), xml::content::complex);
+    skip_attributes();
+
+    index = 0;
+
+    while (in_element(qn("spreadsheetml", "sst")))
+    {
+        while (index < pending.size() && !pending[index])
+        {
+            ++index;
+        }
+
+        expect_start_element(qn("spreadsheetml", "si"), xml::content::complex);
+        values.at(index++) = read_rich_text(qn("spreadsheetml", "si"));
+        expect_end_element(qn("spreadsheetml", "si"));
+    }
+
+    expect_end_element(qn("spreadsheetml", "sst"));
+    parser_ = nullptr;
+
+    impl.shared_strings_source_.reset();
+    impl.shared_strings_pending_.clear();
+    impl.shared_strings_lazy_ = false;
+    impl.shared_strings_table_.clear();
+
+    for (index = 0; index < values.size(); ++index)
+    {
+        impl.shared_strings_table_.insert(values, index);
+    }
+}
+
 void xlsx_consumer::read_shared_workbook_revision_headers()
 {
 }
@@ -2324,6 +3066,15 @@ void xlsx_consumer::read_stylesheet()
     {
         auto current_style_element = expect_start_element(xml::content::complex);
 
+        if (options_.values_only && current_style_element != qn("spreadsheetml", "numFmts")
+            && current_style_element != qn("spreadsheetml", "cellXfs"))
+        {
+            // cell formats are only read for their number formats, which tell dates from numbers
+            skip_element(parser_);
+            stack_.pop_back();
+            continue;
+        }
+
         if (current_style_element == qn("spreadsheetml", "borders"))
         {
             auto &borders = stylesheet.borders;
@@ -2331,8 +3082,9 @@ void xlsx_consumer::read_stylesheet()
 
             while (in_element(qn("spreadsheetml", "borders")))
             {
-                borders.push_back(xlnt::border());
-                auto &border = borders.back();
+                // records are only added once complete so that their hashes in the
+                // stylesheet's index stay valid
+                xlnt::border border;
 
                 expect_start_element(qn("spreadsheetml", "border"), xml::content::complex);
 
@@ -2378,6 +3130,7 @@ void xlsx_consumer::read_stylesheet()
                 }
 
                 expect_end_element(qn("spreadsheetml", "border"));
+                borders.push_back(border);
             }
 
             if (count != borders.size())
@@ -2392,8 +3145,7 @@ void xlsx_consumer::read_stylesheet()
 
             while (in_element(qn("spreadsheetml", "fills")))
             {
-                fills.push_back(xlnt::fill());
-                auto &new_fill = fills.back();
+                xlnt::fill new_fill;
 
                 expect_start_element(qn("spreadsheetml", "fill"), xml::content::complex);
                 auto fill_element = expect_start_element(xml::content::complex);
@@ -2463,6 +3215,7 @@ void xlsx_consumer::read_stylesheet()
 
                 expect_end_element(fill_element);
                 expect_end_element(qn("spreadsheetml", "fill"));
+                fills.push_back(new_fill);
             }
 
             if (count != fills.size())
@@ -2482,8 +3235,7 @@ void xlsx_consumer::read_stylesheet()
 
             while (in_element(qn("spreadsheetml", "fonts")))
             {
-                fonts.push_back(xlnt::font());
-                auto &new_font = stylesheet.fonts.back();
+                xlnt::font new_font;
 
                 expect_start_element(qn("spreadsheetml", "font"), xml::content::complex);
 
@@ -2606,6 +3358,7 @@ void xlsx_consumer::read_stylesheet()
                 }
 
                 expect_end_element(qn("spreadsheetml", "font"));
+                fonts.push_back(new_font);
             }
 
             if (count != stylesheet.fonts.size())
@@ -2694,6 +3447,21 @@ void xlsx_consumer::read_stylesheet()
                         ? format_records.emplace(format_records.end())
                         : style_records.emplace(style_records.end()));
 
+                if (options_.values_only)
+                {
+                    if (parser().attribute_present("applyNumberFormat"))
+                    {
+                        record.first.number_format_applied = is_true(parser().attribute("applyNumberFormat"));
+                    }
+                    record.first.number_format_id = parser().attribute_present("numFmtId")
+                        ? parser().attribute<std::size_t>("numFmtId")
+                        : std::optional<std::size_t>();
+
+                    skip_element(parser_);
+                    stack_.pop_back();
+                    continue;
+                }
+
                 if (parser().attribute_present("applyBorder"))
                 {
                     record.first.border_applied = is_true(parser().attribute("applyBorder"));
@@ -2954,8 +3722,7 @@ void xlsx_consumer::read_stylesheet()
 
     for (const auto &record : format_records)
     {
-        stylesheet.format_impls.push_back(format_impl());
-        auto &new_format = stylesheet.format_impls.back();
+        format_impl new_format;
 
         new_format.id = record_index++;
         new_format.parent = &stylesheet;
@@ -2978,6 +3745,8 @@ void xlsx_consumer::read_stylesheet()
         new_format.quote_prefix_ = record.first.quote_prefix_;
 
         set_style_by_xfid(styles, record.second, new_format.style);
+
+        stylesheet.format_impls.push_back(new_format);
     }
 }
 
@@ -3090,18 +3859,16 @@ void xlsx_consumer::read_unknown_relationships()
 
 void xlsx_consumer::read_image(const xlnt::path &image_path)
 {
-    auto image_streambuf = archive_->open(image_path);
-    vector_ostreambuf buffer(target_.d_->images_[image_path.string()]);
-    std::ostream out_stream(&buffer);
-    out_stream << image_streambuf.get();
+    auto &image = target_.d_->images_[image_path.string()];
+    image.resize(archive_->uncompressed_size(image_path));
+    image.resize(archive_->read_into(image_path, image.data(), image.size()));
 }
 
 void xlsx_consumer::read_binary(const xlnt::path &binary_path)
 {
-    auto binary_streambuf = archive_->open(binary_path);
-    vector_ostreambuf buffer(target_.d_->binaries_[binary_path.string()]);
-    std::ostream out_stream(&buffer);
-    out_stream << binary_streambuf.get();
+    auto &binary = target_.d_->binaries_[binary_path.string()];
+    binary.resize(archive_->uncompressed_size(binary_path));
+    binary.resize(archive_->read_into(binary_path, binary.data(), binary.size()));
 }
 
 std::string xlsx_consumer::read_text()
@@ -28,14 +28,19 @@
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <detail/external/include_libstudxml.hpp>
+#include <detail/serialization/serialisation_helpers.hpp>
 #include <detail/serialization/zstream.hpp>
 #include <xlnt/utils/numeric.hpp>
+#include <xlnt/workbook/load_options.hpp>
+
 namespace xlnt {
 
 class cell;
@@ -53,6 +58,7 @@ class worksheet;
 namespace detail {
 
 class izstream;
+class sheet_data_tokenizer;
 struct cell_impl;
 struct defined_name;
 struct worksheet_impl;
@@ -65,17 +71,39 @@ class xlsx_consumer
 public:
 	xlsx_consumer(workbook &destination);
 
+	xlsx_consumer(workbook &destination, const load_options &options);
+
 	~xlsx_consumer();
 
 	void read(std::istream &source);
 
+	/// <summary>
+	/// Reads an XLSX package held in memory, such as a memory mapped file, without
+	/// copying it. The memory must stay valid until the consumer is destroyed.
+	/// </summary>
+	void read(const std::uint8_t *data, std::size_t size);
+
 	void read(std::istream &source, const std::string &password);
 
+	/// <summary>
+	/// Parses the shared string at index of a table which was loaded with
+	/// load_options::lazy_shared_strings into the destination workbook.
+	/// </summary>
+	void read_shared_string(std::size_t index);
+
+	/// <summary>
+	/// Parses every remaining shared string of a table which was loaded with
+	/// load_options::lazy_shared_strings and releases the decompressed table.
+	/// </summary>
+	void read_shared_strings();
+
 private:
     friend class xlnt::streaming_workbook_reader;
 
     void open(std::istream &source);
 
+    void open(const std::uint8_t *data, std::size_t size);
+
     bool has_cell();
 
     /// <summary>
@@ -158,6 +186,12 @@ private:
 	/// </summary>
 	void read_shared_string_table();
 
+	/// <summary>
+	/// xl/sharedStrings.xml, recording where each string is for reading later
+	/// rather than parsing them.
+	/// </summary>
+	void index_shared_string_table(std::istream &part_stream, const path &part_path);
+
 	/// <summary>
 	///
 	/// </summary>
@@ -213,11 +247,88 @@ private:
     /// </summary>
     void read_worksheet_sheetdata();
 
+    /// <summary>
+    /// Parses the remainder of the current sheetData element on this thread
+    /// while a second thread builds the parsed cells chunk by chunk. Only cells
+    /// inside bounds are kept unless it's null.
+    /// </summary>
+    void read_worksheet_sheetdata_pipelined(const range_reference *bounds);
+
+    /// <summary>
+    /// Reads at most max_rows rows of the current sheetData element into sheet_data,
+    /// as parse_sheet_data does, and returns true once the element has ended. Rows
+    /// are read by sheet_data_tokenizer_ while it can read them and by xml::parser after.
+    /// </summary>
+    bool read_sheet_data_rows(Sheet_Data &sheet_data, std::size_t max_rows, const range_reference *bounds);
+
+    /// <summary>
+    /// Returns the titles of the worksheets selected by load_options::sheet_titles
+    /// and load_options::sheet_indices, or an empty set if every worksheet should be loaded.
+    /// </summary>
+    std::unordered_set<std::string> selected_worksheets(const std::vector<relationship> &worksheet_rels,
+        const std::function<std::string(const relationship &)> &worksheet_title);
+
+    /// <summary>
+    /// Removes worksheets which weren't selected for loading from the workbook
+    /// along with their relationships, keeping the active worksheet if it remains.
+    /// </summary>
+    void remove_worksheets(const std::vector<worksheet_impl *> &worksheets);
+
+    /// <summary>
+    /// Moves rows and cells parsed from sheetData into the current worksheet.
+    /// </summary>
+    void build_worksheet_sheetdata(Sheet_Data &sheet_data);
+
+    /// <summary>
+    /// Sets the format, formula and value of target from a parsed cell.
+    /// The strings in cell may be moved from.
+    /// </summary>
+    void assign_parsed_cell(Cell &cell, detail::cell_impl &target);
+
     /// <summary>
     /// xl/sheets/*.xml
     /// </summary>
     worksheet read_worksheet_end(const std::string &rel_id);
 
+    /// <summary>
+    /// Returns the hyperlink relationships of the worksheet with the given relationship ID.
+    /// </summary>
+    std::vector<relationship> worksheet_hyperlinks(const std::string &rel_id);
+
+    /// <summary>
+    /// Reads the elements following sheetData up to the end of the worksheet part.
+    /// hyperlinks are the worksheet's hyperlink relationships, which are resolved
+    /// beforehand so that this doesn't read the manifest.
+    /// </summary>
+    void read_worksheet_trailing_elements(const std::vector<relationship> &hyperlinks);
+
+    /// <summary>
+    /// Reads the comments, drawings and printer settings parts belonging to the
+    /// current worksheet.
+    /// </summary>
+    void read_worksheet_related_parts(const std::string &rel_id);
+
+    /// <summary>
+    /// Reads the given worksheets on up to thread_count threads. Each worksheet part
+    /// is parsed by its own consumer and the parts they relate to are read afterwards
+    /// on the calling thread.
+    /// </summary>
+    void read_worksheets_concurrently(const relationship &workbook_rel,
+        const std::vector<std::pair<relationship, worksheet_impl *>> &worksheets, std::size_t thread_count);
+
+    /// <summary>
+    /// Locks the workbook while a worksheet being read concurrently modifies
+    /// state shared with other worksheets. Does nothing otherwise.
+    /// </summary>
+    std::unique_lock<std::mutex> lock_workbook();
+
+    /// <summary>
+    /// Removes the formulae of the cells which merging reference will clear, without
+    /// collecting unused formulae across the workbook as clearing them would, since
+    /// that reads worksheets which other threads are still filling in.
+    /// </summary>
+    void drop_merged_formulae(const range_reference &reference);
+
 	// Sheet Relationship Target Parts
 
 	/// <summary>
@@ -410,6 +521,18 @@ private:
 	/// </summary>
 	xml::parser *parser_;
 
+    /// <summary>
+    /// The reader of the rows of the current worksheet's sheetData element if they've
+    /// been left out of parser_ by a tokenized_worksheet, or nullptr.
+    /// </summary>
+    sheet_data_tokenizer *sheet_data_tokenizer_ = nullptr;
+
+    /// <summary>
+    /// The rows which sheet_data_tokenizer_ couldn't read and the parser reading them.
+    /// </summary>
+    std::string sheet_data_fallback_xml_;
+    std::unique_ptr<xml::parser> sheet_data_fallback_parser_;
+
     std::vector<xml::qname> stack_;
 
     bool preserve_space_ = false;
@@ -417,12 +540,37 @@ private:
     bool streaming_ = false;
 
     std::unique_ptr<detail::cell_impl> streaming_cell_;
+
+    /// <summary>
+    /// The most recently streamed cell as parsed, reused so that its buffers are kept.
+    /// </summary>
+    Cell streaming_parsed_cell_;
+
+    /// <summary>
+    /// The row currently being streamed and whether its element is still open.
+    /// </summary>
+    row_t streaming_row_ = 0;
+    bool streaming_in_row_ = false;
     
     std::unordered_map<int, std::string> shared_formulae_;
     std::unordered_map<std::string, std::string> array_formulae_;
 
     detail::worksheet_impl *current_worksheet_;
     number_serialiser converter_;
+
+    load_options options_;
+
+    /// <summary>
+    /// Guards workbook-wide state while worksheets are read concurrently.
+    /// This is null unless this consumer reads one of those worksheets.
+    /// </summary>
+    std::mutex *workbook_mutex_ = nullptr;
+
+    /// <summary>
+    /// Set when drop_merged_formulae removed a formula, so that unused formulae
+    /// are collected once all worksheets have been read.
+    /// </summary>
+    bool merged_formulae_dropped_ = false;
     
     std::vector<defined_name> defined_names_;
 };
@@ -24,6 +24,7 @@
 #include <cmath>
 #include <numeric> // for std::accumulate
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <unordered_set>
 
@@ -42,6 +43,7 @@
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/serialization/custom_value_traits.hpp>
 #include <detail/serialization/defined_name.hpp>
+#include <detail/serialization/sheet_data_writer.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/xlsx_producer.hpp>
 #include <detail/serialization/zstream.hpp>
@@ -80,8 +82,9 @@ std::vector<std::pair<std::string, std::string>> core_property_namespace(xlnt::c
 namespace xlnt {
 namespace detail {
 
-xlsx_producer::xlsx_producer(const workbook &target)
+xlsx_producer::xlsx_producer(const workbook &target, const save_options &options)
     : source_(target),
+      options_(options),
       current_part_stream_(nullptr),
       current_cell_(nullptr),
       current_worksheet_(nullptr)
@@ -96,28 +99,137 @@ xlsx_producer::~xlsx_producer()
 
 void xlsx_producer::write(std::ostream &destination)
 {
-    archive_.reset(new ozstream(destination));
+    auto compression_threads = options_.compression_threads == 0
+        ? static_cast<std::size_t>(std::thread::hardware_concurrency())
+        : options_.compression_threads;
+
+    archive_.reset(new ozstream(destination, default_zstream_buffer_size,
+        compression_threads, options_.compression_level));
     populate_archive(false);
+    archive_->close();
 }
 
 void xlsx_producer::open(std::ostream &destination)
 {
-    archive_.reset(new ozstream(destination));
-    populate_archive(true);
+    // the worksheet being streamed stays open until the next one is started,
+    // so compressing it on a worker would mean buffering all of it
+    archive_.reset(new ozstream(destination, default_zstream_buffer_size, 1, options_.compression_level));
+    streaming_ = true;
+    streaming_cell_.reset(new cell_impl());
+}
+
+void xlsx_producer::begin_worksheet(worksheet ws)
+{
+    end_worksheet();
+    current_worksheet_ = ws.d_;
+
+    const auto rel = worksheet_relationship(ws);
+    begin_part(rel.source().path().parent().append(rel.target().path()));
 }
 
 cell xlsx_producer::add_cell(const cell_reference &ref)
 {
-    current_cell_->column_ = ref.column();
-    current_cell_->row_ = ref.row();
+    if (current_cell_ != nullptr)
+    {
+        if (ref.row() < current_cell_->row_
+            || (ref.row() == current_cell_->row_ && ref.column() <= current_cell_->column_))
+        {
+            throw invalid_parameter();
+        }
+
+        write_streamed_cell();
+    }
+
+    *streaming_cell_ = cell_impl();
+    streaming_cell_->parent_ = current_worksheet_;
+    streaming_cell_->column_ = ref.column();
+    streaming_cell_->row_ = ref.row();
+    current_cell_ = streaming_cell_.get();
 
     return cell(current_cell_);
 }
 
-worksheet xlsx_producer::add_worksheet(const std::string &title)
+void xlsx_producer::write_streamed_cell()
 {
-    current_worksheet_->title_ = title;
-    return worksheet(current_worksheet_);
+    static const auto &xmlns = constants::ns("spreadsheetml");
+
+    if (!sheet_data_started_)
+    {
+        // deferred until now so that properties written before sheetData, like
+        // column widths and views, can still be set on the worksheet after it's added
+        write_worksheet_start(worksheet(current_worksheet_));
+        write_start_element(xmlns, "sheetData");
+        sheet_data_started_ = true;
+    }
+
+    if (current_cell_ == nullptr) return;
+
+    sheet_data_writer out(*current_part_streambuf_);
+
+    if (current_row_ != current_cell_->row_)
+    {
+        if (current_row_ != 0)
+        {
+            out.literal("</row>");
+        }
+        else
+        {
+            // closes the sheetData start tag so that rows can be written directly
+            write_characters("");
+        }
+
+        current_row_ = current_cell_->row_;
+        out.literal("<row r=\"");
+        out.integer(current_row_);
+        out.literal("\">");
+    }
+
+    write_cell(out, cell(current_cell_));
+    out.flush();
+    current_cell_ = nullptr;
+}
+
+void xlsx_producer::end_worksheet()
+{
+    static const auto &xmlns = constants::ns("spreadsheetml");
+
+    if (current_worksheet_ == nullptr) return;
+
+    write_streamed_cell();
+
+    if (current_row_ != 0)
+    {
+        sheet_data_writer out(*current_part_streambuf_);
+        out.literal("</row>");
+        out.flush();
+    }
+
+    write_end_element(xmlns, "sheetData");
+
+    auto ws = worksheet(current_worksheet_);
+
+    // comments and hyperlinks live in the cells, which aren't kept while streaming
+    write_worksheet_end(worksheet_relationship(ws), ws, {}, {});
+    end_part();
+
+    current_worksheet_ = nullptr;
+    sheet_data_started_ = false;
+    current_row_ = 0;
+}
+
+relationship xlsx_producer::worksheet_relationship(worksheet ws) const
+{
+    const auto workbook_rel = source_.manifest().relationship(path("/"), relationship_type::office_document);
+
+    return source_.manifest().relationship(workbook_rel.target().path(),
+        source_.d_->sheet_title_rel_id_map_.at(ws.title()));
+}
+
+void xlsx_producer::close()
+{
+    end_worksheet();
+    populate_archive(true);
+    archive_->close();
 }
 
 // Part Writing Methods
@@ -742,6 +854,12 @@ void xlsx_producer::write_workbook(const relationship &rel)
             continue;
         }
 
+        // worksheets were written as their cells arrived
+        if (streaming_ && child_rel.type() == relationship_type::worksheet)
+        {
+            continue;
+        }
+
         // write xml
         begin_part(archive_path);
 
@@ -991,30 +1109,12 @@ void xlsx_producer::write_shared_string_table(const relationship & /*rel*/)
     write_start_element(xmlns, "sst");
     write_namespace(xmlns, "");
 
-    // todo: is there a more elegant way to get this number?
+    // each sheet's cell store keeps its shared string count current
     std::size_t string_count = 0;
 
     for (const auto ws : source_)
     {
-        auto dimension = ws.calculate_dimension();
-        auto current_cell = dimension.top_left();
-
-        while (current_cell.row() <= dimension.bottom_right().row())
-        {
-            while (current_cell.column() <= dimension.bottom_right().column())
-            {
-                auto c_iter = ws.d_->cell_map_.find(current_cell);
-                if (c_iter != ws.d_->cell_map_.end() && c_iter->second.type_ == cell_type::shared_string)
-                {
-                    ++string_count;
-                }
-
-                current_cell.column_index(current_cell.column_index() + 1);
-            }
-
-            current_cell.row(current_cell.row() + 1);
-            current_cell.column_index(dimension.top_left().column_index());
-        }
+        string_count += ws.d_->cell_map_.shared_string_count();
     }
 
     write_attribute("count", string_count);
@@ -2254,12 +2354,6 @@ void xlsx_producer::write_volatile_dependencies(const relationship & /*rel*/)
 void xlsx_producer::write_worksheet(const relationship &rel)
 {
     static const auto &xmlns = constants::ns("spreadsheetml");
-    static const auto &xmlns_r = constants::ns("r");
-    static const auto &xmlns_mc = constants::ns("mc");
-    static const auto &xmlns_x14ac = constants::ns("x14ac");
-
-    auto worksheet_part = rel.source().path().parent().append(rel.target().path());
-    auto worksheet_rels = source_.manifest().relationships(worksheet_part);
 
     auto title = std::find_if(source_.d_->sheet_title_rel_id_map_.begin(), source_.d_->sheet_title_rel_id_map_.end(),
         [&](const std::pair<std::string, std::string> &p) {
@@ -2268,6 +2362,194 @@ void xlsx_producer::write_worksheet(const relationship &rel)
 
     auto ws = source_.sheet_by_title(title);
 
+    write_worksheet_start(ws);
+
+    std::vector<std::pair<std::string, hyperlink>> hyperlinks;
+    std::vector<cell_reference> cells_with_comments;
+
+    write_start_element(xmlns, "sheetData");
+    const auto first_row = ws.lowest_row_or_props();
+
+    // Only existing cells are visited, in row-major order, so the size of the
+    // dimension doesn't matter. cells holds the ones to write and row_starts
+    // the row of each run of cells in it along with the run's first position.
+    std::vector<detail::cell_impl *> cells;
+    std::vector<std::pair<row_t, std::size_t>> row_starts;
+
+    for (auto &impl : ws.d_->cell_map_)
+    {
+        if (impl.is_garbage_collectible()) continue;
+
+        if (row_starts.empty() || row_starts.back().first != impl.row_)
+        {
+            row_starts.emplace_back(impl.row_, cells.size());
+        }
+
+        cells.push_back(&impl);
+    }
+
+    auto row_cells_end = [&](std::size_t row_start) {
+        return row_start + 1 < row_starts.size() ? row_starts[row_start + 1].second : cells.size();
+    };
+
+    std::vector<row_t> rows;
+    rows.reserve(row_starts.size() + ws.d_->row_properties_.size());
+
+    for (const auto &row_start : row_starts)
+    {
+        rows.push_back(row_start.first);
+    }
+
+    for (const auto &props : ws.d_->row_properties_)
+    {
+        rows.push_back(props.first);
+    }
+
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+    if (!rows.empty())
+    {
+        // closes the sheetData start tag so that rows can be written directly
+        write_characters("");
+    }
+
+    // rows and the cells holding plain values bypass the serializer
+    sheet_data_writer out(*current_part_streambuf_);
+    std::size_t next_row_start = 0;
+    auto block_start = row_t(0);
+    auto first_block_column = constants::max_column();
+    auto last_block_column = constants::min_column();
+
+    for (auto row : rows)
+    {
+        // See note for CT_Row, span attribute about block optimization.
+        // Blocks are rows 1-16, 17-32 and so on, except that the first
+        // block starts at the first row and runs to the next multiple of 16.
+        const auto row_block_start = std::max(first_row, row - (row - 1) % 16);
+
+        if (row_block_start != block_start)
+        {
+            block_start = row_block_start;
+            const auto block_end = (block_start / 16 + 1) * 16;
+            first_block_column = constants::max_column();
+            last_block_column = constants::min_column();
+
+            auto row_start = std::lower_bound(row_starts.begin(), row_starts.end(), block_start,
+                [](const std::pair<row_t, std::size_t> &r, row_t value) { return r.first < value; });
+
+            for (; row_start != row_starts.end() && row_start->first <= block_end; ++row_start)
+            {
+                const auto index = static_cast<std::size_t>(row_start - row_starts.begin());
+                first_block_column = std::min(first_block_column, cells[row_start->second]->column_);
+                last_block_column = std::max(last_block_column, cells[row_cells_end(index) - 1]->column_);
+            }
+        }
+
+        const auto any_non_null = next_row_start < row_starts.size() && row_starts[next_row_start].first == row;
+
+        out.literal("<row r=\"");
+        out.integer(row);
+        out.literal("\" spans=\"");
+        out.integer(first_block_column.index);
+        out.literal(":");
+        out.integer(last_block_column.index);
+        out.literal("\"");
+
+        auto props = ws.d_->row_properties_.find(row);
+
+        if (props != ws.d_->row_properties_.end())
+        {
+            if (props->second.style)
+            {
+                out.literal(" s=\"");
+                out.integer(props->second.style.value());
+                out.literal("\"");
+            }
+
+            if (props->second.custom_format)
+            {
+                if (props->second.custom_format.value())
+                {
+                    out.literal(" customFormat=\"1\"");
+                }
+                else
+                {
+                    out.literal(" customFormat=\"0\"");
+                }
+            }
+
+            if (props->second.height)
+            {
+                out.literal(" ht=\"");
+                out.number(props->second.height.value());
+                out.literal("\"");
+            }
+
+            if (props->second.hidden)
+            {
+                out.literal(" hidden=\"1\"");
+            }
+
+            if (props->second.custom_height)
+            {
+                out.literal(" customHeight=\"1\"");
+            }
+
+            // write_worksheet_start declares the x14ac prefix whenever a row uses it
+            if (props->second.dy_descent)
+            {
+                out.literal(" x14ac:dyDescent=\"");
+                out.number(props->second.dy_descent.value());
+                out.literal("\"");
+            }
+        }
+
+        if (!any_non_null)
+        {
+            out.literal("/>");
+            continue;
+        }
+
+        out.literal(">");
+        const auto row_end = row_cells_end(next_row_start);
+
+        for (auto index = row_starts[next_row_start].second; index < row_end; ++index)
+        {
+            auto cell = xlnt::cell(cells[index]);
+
+            // record data about the cell needed later
+
+            if (cell.has_comment())
+            {
+                cells_with_comments.push_back(cell.reference());
+            }
+
+            if (cell.has_hyperlink())
+            {
+                hyperlinks.push_back(std::make_pair(cell.reference().to_string(), cell.hyperlink()));
+            }
+
+            write_cell(out, cell);
+        }
+
+        ++next_row_start;
+        out.literal("</row>");
+    }
+
+    out.flush();
+    write_end_element(xmlns, "sheetData");
+
+    write_worksheet_end(rel, ws, hyperlinks, cells_with_comments);
+}
+
+void xlsx_producer::write_worksheet_start(worksheet ws)
+{
+    static const auto &xmlns = constants::ns("spreadsheetml");
+    static const auto &xmlns_r = constants::ns("r");
+    static const auto &xmlns_mc = constants::ns("mc");
+    static const auto &xmlns_x14ac = constants::ns("x14ac");
+
     write_start_element(xmlns, "worksheet");
     write_namespace(xmlns, "");
     write_namespace(xmlns_r, "r");
@@ -2280,10 +2562,11 @@ void xlsx_producer::write_worksheet(const relationship &rel)
                 return true;
             }
 
-            auto highest = ws.highest_row();
-            for (auto row = ws.lowest_row(); row <= highest; ++row)
+            // rows are written directly, so the prefix has to be declared here
+            // for every row that uses it, including rows outside the cell bounds
+            for (const auto &props : ws.d_->row_properties_)
             {
-                if (ws.has_row_properties(row) && ws.row_properties(row).dy_descent)
+                if (props.second.dy_descent)
                 {
                     return true;
                 }
@@ -2355,10 +2638,15 @@ void xlsx_producer::write_worksheet(const relationship &rel)
         write_end_element(xmlns, "sheetPr");
     }
 
-    write_start_element(xmlns, "dimension");
-    const auto dimension = ws.calculate_dimension();
-    write_attribute("ref", dimension.is_single_cell() ? dimension.top_left().to_string() : dimension.to_string());
-    write_end_element(xmlns, "dimension");
+    // the extent of a streamed sheet isn't known until its last row has been
+    // written and dimension is optional, so it's left out in that case
+    if (!streaming_)
+    {
+        write_start_element(xmlns, "dimension");
+        const auto dimension = ws.calculate_dimension();
+        write_attribute("ref", dimension.is_single_cell() ? dimension.top_left().to_string() : dimension.to_string());
+        write_end_element(xmlns, "dimension");
+    }
 
     if (ws.has_view())
     {
@@ -2528,233 +2816,182 @@ void xlsx_producer::write_worksheet(const relationship &rel)
     {
         write_end_element(xmlns, "cols");
     }
+}
 
-    std::vector<std::pair<std::string, hyperlink>> hyperlinks;
-    std::vector<cell_reference> cells_with_comments;
-
-    write_start_element(xmlns, "sheetData");
-    auto first_row = ws.lowest_row_or_props();
-    auto last_row = ws.highest_row_or_props();
-    auto first_block_column = constants::max_column();
-    auto last_block_column = constants::min_column();
-
-    for (auto row = first_row; row <= last_row; ++row)
-    {
-        bool any_non_null = false;
-        auto first_check_row = row;
-        auto last_check_row = row;
-        auto first_row_in_block = row == first_row || row % 16 == 1;
-
-        // See note for CT_Row, span attribute about block optimization
-        if (first_row_in_block)
-        {
-            // reset block column range
-            first_block_column = constants::max_column();
-            last_block_column = constants::min_column();
-
-            first_check_row = row;
-            // round up to the next multiple of 16
-            last_check_row = ((row / 16) + 1) * 16;
-        }
-
-        for (auto check_row = first_check_row; check_row <= last_check_row; ++check_row)
-        {
-            for (auto column = dimension.top_left().column(); column <= dimension.bottom_right().column(); ++column)
-            {
-                auto ref = cell_reference(column, check_row);
-                auto cell = ws.d_->cell_map_.find(ref);
-                if (cell == ws.d_->cell_map_.end())
-                {
-                    continue;
-                }
-                if (cell->second.is_garbage_collectible())
-                {
-                    continue;
-                }
-
-                first_block_column = std::min(first_block_column, cell->second.column_);
-                last_block_column = std::max(last_block_column, cell->second.column_);
-
-                if (row == check_row)
-                {
-                    any_non_null = true;
-                }
-            }
-        }
+void xlsx_producer::write_cell(const cell &c)
+{
+    static const auto &xmlns = constants::ns("spreadsheetml");
 
-        if (!any_non_null && !ws.has_row_properties(row)) continue;
+    write_start_element(xmlns, "c");
 
-        write_start_element(xmlns, "row");
-        write_attribute("r", row);
+    // begin cell attributes
 
-        auto span_string = std::to_string(first_block_column.index) + ":"
-            + std::to_string(last_block_column.index);
-        write_attribute("spans", span_string);
+    write_attribute("r", c.reference().to_string());
 
-        if (ws.has_row_properties(row))
-        {
-            const auto &props = ws.row_properties(row);
+    if (c.phonetics_visible())
+    {
+        write_attribute("ph", write_bool(true));
+    }
 
-            if (props.style)
-            {
-                write_attribute("s", props.style.value());
-            }
-            if (props.custom_format)
-            {
-                write_attribute("customFormat", write_bool(props.custom_format.value()));
-            }
+    if (c.has_format())
+    {
+        write_attribute("s", c.format().d_->id);
+    }
 
-            if (props.height)
-            {
-                auto height = props.height.value();
-                write_attribute("ht", converter_.serialise(height));
-            }
+    switch (c.data_type())
+    {
+    case cell::type::empty:
+        break;
 
-            if (props.hidden)
-            {
-                write_attribute("hidden", write_bool(true));
-            }
+    case cell::type::boolean:
+        write_attribute("t", "b");
+        break;
 
-            if (props.custom_height)
-            {
-                write_attribute("customHeight", write_bool(true));
-            }
+    case cell::type::date:
+        write_attribute("t", "d");
+        break;
 
-            if (props.dy_descent)
-            {
-                write_attribute<double>(xml::qname(xmlns_x14ac, "dyDescent"), props.dy_descent.value());
-            }
-        }
+    case cell::type::error:
+        write_attribute("t", "e");
+        break;
 
-        if (any_non_null)
-        {
-            for (auto column = dimension.top_left().column(); column <= dimension.bottom_right().column(); ++column)
-            {
-                if (!ws.has_cell(cell_reference(column, row))) continue;
+    case cell::type::inline_string:
+        write_attribute("t", "inlineStr");
+        break;
 
-                auto cell = ws.cell(cell_reference(column, row));
+    case cell::type::number: // default, don't write it
+        //write_attribute("t", "n");
+        break;
 
-                if (cell.garbage_collectible()) continue;
+    case cell::type::shared_string:
+        write_attribute("t", "s");
+        break;
 
-                // record data about the cell needed later
+    case cell::type::formula_string:
+        write_attribute("t", "str");
+        break;
+    }
 
-                if (cell.has_comment())
-                {
-                    cells_with_comments.push_back(cell.reference());
-                }
+    //write_attribute("cm", "");
+    //write_attribute("vm", "");
+    //write_attribute("ph", "");
 
-                if (cell.has_hyperlink())
-                {
-                    hyperlinks.push_back(std::make_pair(cell.reference().to_string(), cell.hyperlink()));
-                }
+    // begin child elements
 
-                write_start_element(xmlns, "c");
+    if (c.has_formula())
+    {
+        write_element(xmlns, "f", c.formula());
+    }
 
-                // begin cell attributes
+    switch (c.data_type())
+    {
+    case cell::type::empty:
+        break;
 
-                write_attribute("r", cell.reference().to_string());
+    case cell::type::boolean:
+        write_element(xmlns, "v", write_bool(c.value<bool>()));
+        break;
 
-                if (cell.phonetics_visible())
-                {
-                    write_attribute("ph", write_bool(true));
-                }
+    case cell::type::date:
+        write_element(xmlns, "v", c.value<std::string>());
+        break;
 
-                if (cell.has_format())
-                {
-                    write_attribute("s", cell.format().d_->id);
-                }
+    case cell::type::error:
+        write_element(xmlns, "v", c.value<std::string>());
+        break;
 
-                switch (cell.data_type())
-                {
-                case cell::type::empty:
-                    break;
+    case cell::type::inline_string:
+        write_start_element(xmlns, "is");
+        write_rich_text(xmlns, c.value<xlnt::rich_text>());
+        write_end_element(xmlns, "is");
+        break;
 
-                case cell::type::boolean:
-                    write_attribute("t", "b");
-                    break;
+    case cell::type::number:
+        write_start_element(xmlns, "v");
+        write_characters(converter_.serialise(c.value<double>()));
+        write_end_element(xmlns, "v");
+        break;
 
-                case cell::type::date:
-                    write_attribute("t", "d");
-                    break;
+    case cell::type::shared_string:
+        write_element(xmlns, "v", static_cast<std::size_t>(c.d_->value_numeric_));
+        break;
 
-                case cell::type::error:
-                    write_attribute("t", "e");
-                    break;
+    case cell::type::formula_string:
+        write_element(xmlns, "v", c.value<std::string>());
+        break;
+    }
 
-                case cell::type::inline_string:
-                    write_attribute("t", "inlineStr");
-                    break;
+    write_end_element(xmlns, "c");
+}
 
-                case cell::type::number: // default, don't write it
-                    //write_attribute("t", "n");
-                    break;
+void xlsx_producer::write_cell(sheet_data_writer &out, const cell &c)
+{
+    const auto &impl = *c.d_;
 
-                case cell::type::shared_string:
-                    write_attribute("t", "s");
-                    break;
+    if (impl.formula().has_value() || (impl.type_ != cell::type::empty && impl.type_ != cell::type::number
+        && impl.type_ != cell::type::shared_string && impl.type_ != cell::type::boolean))
+    {
+        out.flush();
+        write_cell(c);
+        return;
+    }
 
-                case cell::type::formula_string:
-                    write_attribute("t", "str");
-                    break;
-                }
+    out.literal("<c r=\"");
+    out.reference(impl.column_.index, impl.row_);
+    out.literal("\"");
 
-                //write_attribute("cm", "");
-                //write_attribute("vm", "");
-                //write_attribute("ph", "");
+    if (impl.phonetics_visible_)
+    {
+        out.literal(" ph=\"1\"");
+    }
 
-                // begin child elements
+    if (impl.format_ != nullptr)
+    {
+        out.literal(" s=\"");
+        out.integer(impl.format_->id);
+        out.literal("\"");
+    }
 
-                if (cell.has_formula())
-                {
-                    write_element(xmlns, "f", cell.formula());
-                }
+    switch (impl.type_)
+    {
+    case cell::type::number:
+        out.literal("><v>");
+        out.number(impl.value_numeric_);
+        out.literal("</v></c>");
+        break;
 
-                switch (cell.data_type())
-                {
-                case cell::type::empty:
-                    break;
-
-                case cell::type::boolean:
-                    write_element(xmlns, "v", write_bool(cell.value<bool>()));
-                    break;
-
-                case cell::type::date:
-                    write_element(xmlns, "v", cell.value<std::string>());
-                    break;
-
-                case cell::type::error:
-                    write_element(xmlns, "v", cell.value<std::string>());
-                    break;
-
-                case cell::type::inline_string:
-                    write_start_element(xmlns, "is");
-                    write_rich_text(xmlns, cell.value<xlnt::rich_text>());
-                    write_end_element(xmlns, "is");
-                    break;
-
-                case cell::type::number:
-                    write_start_element(xmlns, "v");
-                    write_characters(converter_.serialise(cell.value<double>()));
-                    write_end_element(xmlns, "v");
-                    break;
-
-                case cell::type::shared_string:
-                    write_element(xmlns, "v", static_cast<std::size_t>(cell.d_->value_numeric_));
-                    break;
-
-                case cell::type::formula_string:
-                    write_element(xmlns, "v", cell.value<std::string>());
-                    break;
-                }
+    case cell::type::shared_string:
+        out.literal(" t=\"s\"><v>");
+        out.integer(static_cast<std::size_t>(impl.value_numeric_));
+        out.literal("</v></c>");
+        break;
 
-                write_end_element(xmlns, "c");
-            }
+    case cell::type::boolean:
+        if (impl.value_numeric_ != 0.0)
+        {
+            out.literal(" t=\"b\"><v>1</v></c>");
         }
+        else
+        {
+            out.literal(" t=\"b\"><v>0</v></c>");
+        }
+        break;
 
-        write_end_element(xmlns, "row");
+    default:
+        out.literal("/>");
+        break;
     }
+}
 
-    write_end_element(xmlns, "sheetData");
+void xlsx_producer::write_worksheet_end(const relationship &rel, worksheet ws,
+    const std::vector<std::pair<std::string, hyperlink>> &hyperlinks,
+    const std::vector<cell_reference> &cells_with_comments)
+{
+    static const auto &xmlns = constants::ns("spreadsheetml");
+    static const auto &xmlns_r = constants::ns("r");
+
+    auto worksheet_part = rel.source().path().parent().append(rel.target().path());
+    auto worksheet_rels = source_.manifest().relationships(worksheet_part);
 
     if (ws.has_auto_filter())
     {
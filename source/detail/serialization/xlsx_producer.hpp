@@ -26,10 +26,13 @@
 #include <cstdint>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <xlnt/utils/numeric.hpp>
+#include <xlnt/workbook/save_options.hpp>
 #include <detail/constants.hpp>
 #include <detail/external/include_libstudxml.hpp>
 
@@ -45,6 +48,7 @@ class cell_reference;
 class color;
 class fill;
 class font;
+class hyperlink;
 class path;
 class relationship;
 class rich_text;
@@ -56,6 +60,7 @@ class worksheet;
 namespace detail {
 
 class ozstream;
+class sheet_data_writer;
 struct cell_impl;
 struct worksheet_impl;
 
@@ -65,7 +70,7 @@ struct worksheet_impl;
 class xlsx_producer
 {
 public:
-	xlsx_producer(const workbook &target);
+	xlsx_producer(const workbook &target, const save_options &options = save_options());
 
     ~xlsx_producer();
 
@@ -76,11 +81,34 @@ public:
 private:
     friend class xlnt::streaming_workbook_writer;
 
+    /// <summary>
+    /// Begins a streamed workbook in destination. Nothing is written until
+    /// the first worksheet is started.
+    /// </summary>
     void open(std::ostream &destination);
 
+    /// <summary>
+    /// Finishes the worksheet currently being streamed, if any, and makes ws
+    /// the target of subsequent calls to add_cell.
+    /// </summary>
+    void begin_worksheet(worksheet ws);
+
+    /// <summary>
+    /// Serializes the previously added cell and returns a cell at ref whose
+    /// value and format will be written by the next call to add_cell or close.
+    /// ref must come after the previous cell in row-major order.
+    /// </summary>
     cell add_cell(const cell_reference &ref);
 
-    worksheet add_worksheet(const std::string &title);
+    /// <summary>
+    /// Finishes the streamed worksheet and writes all remaining parts,
+    /// including the shared strings and styles collected while streaming.
+    /// </summary>
+    void close();
+
+    void end_worksheet();
+    void write_streamed_cell();
+    relationship worksheet_relationship(worksheet ws) const;
 
 	/// <summary>
 	/// Write all files needed to create a valid XLSX file which represents all
@@ -122,6 +150,18 @@ private:
 	void write_chartsheet(const relationship &rel);
 	void write_dialogsheet(const relationship &rel);
 	void write_worksheet(const relationship &rel);
+    void write_worksheet_start(worksheet ws);
+    void write_cell(const cell &c);
+
+    /// <summary>
+    /// Writes c straight to out when it holds nothing but a number, shared
+    /// string or boolean. Other cells are written through the serializer
+    /// after flushing out.
+    /// </summary>
+    void write_cell(sheet_data_writer &out, const cell &c);
+    void write_worksheet_end(const relationship &rel, worksheet ws,
+        const std::vector<std::pair<std::string, hyperlink>> &hyperlinks,
+        const std::vector<cell_reference> &cells_with_comments);
 
 	// Sheet Relationship Target Parts
 
@@ -228,6 +268,8 @@ private:
 	/// </summary>
 	const workbook &source_;
 
+    save_options options_;
+
 	std::unique_ptr<ozstream> archive_;
     std::unique_ptr<xml::serializer> current_part_serializer_;
     std::unique_ptr<std::streambuf> current_part_streambuf_;
@@ -235,11 +277,30 @@ private:
 
     bool streaming_ = false;
 
+    /// <summary>
+    /// The cell most recently returned by add_cell, reused for every streamed cell.
+    /// </summary>
     std::unique_ptr<detail::cell_impl> streaming_cell_;
 
+    /// <summary>
+    /// Points to streaming_cell_ while it holds a cell that hasn't been written yet.
+    /// </summary>
     detail::cell_impl *current_cell_;
 
+    /// <summary>
+    /// The worksheet being streamed or nullptr.
+    /// </summary>
     detail::worksheet_impl *current_worksheet_;
+
+    /// <summary>
+    /// True once the start of the streamed worksheet up to sheetData has been written.
+    /// </summary>
+    bool sheet_data_started_ = false;
+
+    /// <summary>
+    /// The row of the open row element in the streamed worksheet or 0.
+    /// </summary>
+    row_t current_row_ = 0;
     detail::number_serialiser converter_;
 };
 
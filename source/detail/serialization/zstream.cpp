@@ -34,15 +34,20 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 */
 
 #include <algorithm>
-#include <array>
 #include <cassert>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <iterator> // for std::back_inserter
+#include <limits>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 #include <miniz.h>
 
 #include <xlnt/utils/exceptions.hpp>
@@ -169,16 +174,19 @@ void write_header(const xlnt::detail::zheader &header, std::ostream &ostream, co
 namespace xlnt {
 namespace detail {
 
-static const std::size_t buffer_size = 512;
+// streambufs keep up to 4 bytes of putback or alignment slack in their buffers
+static const std::size_t min_buffer_size = 16;
 
 class zip_streambuf_decompress : public std::streambuf
 {
     std::istream &istream;
 
     z_stream strm;
-    std::array<char, buffer_size> in;
-    std::array<char, buffer_size> out;
+    std::size_t buffer_size;
+    std::vector<char> in;
+    std::vector<char> out;
     zheader header;
+    const char *memory_data;
     std::size_t total_read;
     std::size_t total_uncompressed;
     bool valid;
@@ -188,23 +196,34 @@ class zip_streambuf_decompress : public std::streambuf
     static const unsigned short UNCOMPRESSED = 0;
 
 public:
-    zip_streambuf_decompress(std::istream &stream, zheader central_header)
-        : istream(stream), header(central_header), total_read(0), total_uncompressed(0), valid(true)
+    // When compressed_data_ is given, the file's data is read from there instead of stream,
+    // which is then left untouched. Otherwise stream must be positioned at the local header.
+    zip_streambuf_decompress(std::istream &stream, zheader central_header, std::size_t buffer_size_,
+        const char *compressed_data_ = nullptr)
+        : istream(stream),
+          buffer_size(buffer_size_),
+          in(compressed_data_ == nullptr ? buffer_size_ : 0, 0),
+          out(buffer_size_, 0),
+          header(central_header),
+          memory_data(compressed_data_),
+          total_read(0),
+          total_uncompressed(0),
+          valid(true)
     {
-        in.fill(0);
-        out.fill(0);
-
         strm.zalloc = nullptr;
         strm.zfree = nullptr;
         strm.opaque = nullptr;
         strm.avail_in = 0;
         strm.next_in = nullptr;
 
-        setg(in.data(), in.data(), in.data());
+        setg(out.data(), out.data(), out.data());
         setp(nullptr, nullptr);
 
-        // skip the header
-        read_header(istream, false);
+        if (memory_data == nullptr)
+        {
+            // skip the header
+            read_header(istream, false);
+        }
 
         if (header.compression_type == DEFLATE)
         {
@@ -235,6 +254,14 @@ public:
         }
 
         header = central_header;
+
+        if (memory_data != nullptr && !compressed_data)
+        {
+            // stored data can be handed out directly
+            auto begin = const_cast<char *>(memory_data);
+            setg(begin, begin, begin + header.uncompressed_size);
+            total_read = header.uncompressed_size;
+        }
     }
 
     ~zip_streambuf_decompress() override
@@ -251,24 +278,37 @@ public:
 
         if (compressed_data)
         {
-            strm.avail_out = buffer_size - 4;
+            strm.avail_out = static_cast<unsigned int>(buffer_size - 4);
             strm.next_out = reinterpret_cast<Bytef *>(out.data() + 4);
 
             while (strm.avail_out != 0)
             {
                 if (strm.avail_in == 0)
                 {
-                    // buffer empty, read some more from file
-                    istream.read(in.data(),
-                        static_cast<std::streamsize>(std::min(buffer_size, header.compressed_size - total_read)));
-                    strm.avail_in = static_cast<unsigned int>(istream.gcount());
+                    if (memory_data != nullptr)
+                    {
+                        // all of the input is available at once
+                        strm.next_in = reinterpret_cast<const Bytef *>(memory_data + total_read);
+                        strm.avail_in = static_cast<unsigned int>(header.compressed_size - total_read);
+                    }
+                    else
+                    {
+                        // buffer empty, read some more from file
+                        istream.read(in.data(),
+                            static_cast<std::streamsize>(std::min(buffer_size, header.compressed_size - total_read)));
+                        strm.avail_in = static_cast<unsigned int>(istream.gcount());
+                        strm.next_in = reinterpret_cast<Bytef *>(in.data());
+                    }
+
                     total_read += strm.avail_in;
-                    strm.next_in = reinterpret_cast<Bytef *>(in.data());
                 }
 
                 const auto ret = inflate(&strm, Z_NO_FLUSH); // decompress
 
-                if (ret == Z_STREAM_ERROR || ret == Z_NEED_DICT || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR)
+                // Z_BUF_ERROR means no more input could be read before the deflate stream
+                // ended, so the entry is truncated
+                if (ret == Z_STREAM_ERROR || ret == Z_NEED_DICT || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR
+                    || ret == Z_BUF_ERROR)
                 {
                     throw xlnt::exception("couldn't inflate ZIP, possibly corrupted");
                 }
@@ -281,6 +321,9 @@ public:
             return static_cast<int>(unzip_count);
         }
 
+        // uncompressed and already handed out in full by the constructor
+        if (memory_data != nullptr) return 0;
+
         // uncompressed, so just read
         istream.read(out.data() + 4,
             static_cast<std::streamsize>(std::min(buffer_size - 4, header.uncompressed_size - total_read)));
@@ -316,33 +359,49 @@ class zip_streambuf_compress : public std::streambuf
     std::ostream &ostream; // owned when header==0 (when not part of zip file)
 
     z_stream strm;
-    std::array<char, buffer_size> in;
-    std::array<char, buffer_size> out;
+    std::size_t buffer_size;
+    std::vector<char> in;
+    std::vector<char> out;
 
     zheader *header;
     std::uint32_t uncompressed_size;
     std::uint32_t crc;
 
     bool valid;
+    bool stored; // level 0 writes the data as is instead of deflating it
 
 public:
-    zip_streambuf_compress(zheader *central_header, std::ostream &stream)
-        : ostream(stream), header(central_header), valid(true)
+    zip_streambuf_compress(zheader *central_header, std::ostream &stream, std::size_t buffer_size_,
+        int compression_level = Z_DEFAULT_COMPRESSION)
+        : ostream(stream),
+          buffer_size(buffer_size_),
+          in(buffer_size_),
+          out(compression_level == 0 ? 0 : buffer_size_),
+          header(central_header),
+          valid(true),
+          stored(compression_level == 0)
     {
         strm.zalloc = nullptr;
         strm.zfree = nullptr;
         strm.opaque = nullptr;
 
+        if (stored)
+        {
+            if (header) header->compression_type = 0;
+        }
+        else
+        {
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wold-style-cast"
-        int ret = deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+            int ret = deflateInit2(&strm, compression_level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
 #pragma clang diagnostic pop
 
-        if (ret != Z_OK)
-        {
-            std::cerr << "libz: failed to deflateInit" << std::endl;
-            valid = false;
-            return;
+            if (ret != Z_OK)
+            {
+                std::cerr << "libz: failed to deflateInit" << std::endl;
+                valid = false;
+                return;
+            }
         }
 
         setg(nullptr, nullptr, nullptr);
@@ -363,7 +422,7 @@ public:
         if (valid)
         {
             process(true);
-            deflateEnd(&strm);
+            if (!stored) deflateEnd(&strm);
             if (header)
             {
                 auto final_position = ostream.tellp();
@@ -387,12 +446,19 @@ protected:
     {
         if (!valid) return -1;
 
+        if (stored)
+        {
+            const auto input_size = static_cast<std::uint32_t>(pptr() - pbase());
+            ostream.write(pbase(), input_size);
+            if (header) header->compressed_size += input_size;
+        }
+
         strm.next_in = reinterpret_cast<Bytef *>(pbase());
         strm.avail_in = static_cast<unsigned int>(pptr() - pbase());
 
-        while (strm.avail_in != 0 || flush)
+        while (!stored && (strm.avail_in != 0 || flush))
         {
-            strm.avail_out = buffer_size;
+            strm.avail_out = static_cast<unsigned int>(buffer_size);
             strm.next_out = reinterpret_cast<Bytef *>(out.data());
 
             int ret = deflate(&strm, flush ? Z_FINISH : Z_NO_FLUSH);
@@ -444,17 +510,252 @@ int zip_streambuf_compress::overflow(int c)
     return c;
 }
 
-ozstream::ozstream(std::ostream &stream)
-    : destination_stream_(stream)
+/// <summary>
+/// A file which has been written in full and is waiting to be compressed.
+/// data holds the uncompressed bytes until a worker replaces them with the
+/// deflated bytes and fills in the sizes and crc of header.
+/// </summary>
+struct ozstream::deflated_file
+{
+    zheader header;
+    std::vector<char> data;
+    int compression_level = Z_DEFAULT_COMPRESSION;
+    bool done = false;
+    std::exception_ptr error;
+};
+
+/// <summary>
+/// The worker threads of an ozstream and the files they are compressing.
+/// </summary>
+struct ozstream::deflate_pool
+{
+    explicit deflate_pool(std::size_t thread_count)
+    {
+        for (std::size_t i = 0; i < thread_count; ++i)
+        {
+            workers.emplace_back([this]() { run(); });
+        }
+    }
+
+    ~deflate_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+
+        work_available.notify_all();
+
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (true)
+        {
+            work_available.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (queue.empty()) return;
+
+            auto file = queue.front();
+            queue.pop_front();
+            lock.unlock();
+
+            try
+            {
+                compress(*file);
+            }
+            catch (...)
+            {
+                file->error = std::current_exception();
+            }
+
+            lock.lock();
+            file->done = true;
+            work_done.notify_all();
+        }
+    }
+
+    static void compress(deflated_file &file)
+    {
+        if (file.data.size() > std::numeric_limits<std::uint32_t>::max())
+        {
+            throw xlnt::exception("file is too large for a ZIP archive");
+        }
+
+        const auto uncompressed_size = static_cast<std::uint32_t>(file.data.size());
+        file.header.crc = static_cast<std::uint32_t>(crc32(0,
+            reinterpret_cast<const Bytef *>(file.data.data()), uncompressed_size));
+        file.header.uncompressed_size = uncompressed_size;
+
+        if (file.compression_level == 0)
+        {
+            file.header.compression_type = 0;
+            file.header.compressed_size = uncompressed_size;
+
+            return;
+        }
+
+        z_stream strm;
+        strm.zalloc = nullptr;
+        strm.zfree = nullptr;
+        strm.opaque = nullptr;
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+        int ret = deflateInit2(&strm, file.compression_level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+#pragma clang diagnostic pop
+
+        if (ret != Z_OK)
+        {
+            throw xlnt::exception("libz: failed to deflateInit");
+        }
+
+        std::vector<char> compressed(deflateBound(&strm, uncompressed_size));
+
+        strm.next_in = reinterpret_cast<const Bytef *>(file.data.data());
+        strm.avail_in = uncompressed_size;
+        strm.next_out = reinterpret_cast<Bytef *>(compressed.data());
+        strm.avail_out = static_cast<unsigned int>(compressed.size());
+
+        ret = deflate(&strm, Z_FINISH);
+        const auto compressed_size = static_cast<std::uint32_t>(strm.total_out);
+        deflateEnd(&strm);
+
+        if (ret != Z_STREAM_END)
+        {
+            throw xlnt::exception("libz: failed to deflate");
+        }
+
+        file.header.compressed_size = compressed_size;
+
+        compressed.resize(compressed_size);
+        file.data.swap(compressed);
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable work_done;
+    std::deque<deflated_file *> queue;
+    bool stopping = false;
+
+    /// <summary>
+    /// Files which haven't been written to the archive yet in the order they
+    /// were opened. Only used by the thread which owns the ozstream.
+    /// </summary>
+    std::deque<std::unique_ptr<deflated_file>> pending;
+};
+
+/// <summary>
+/// Collects a file in memory and passes it to the ozstream's workers when it's
+/// destroyed, rather than compressing it while it's being written.
+/// </summary>
+class zip_streambuf_deferred : public std::streambuf
+{
+public:
+    zip_streambuf_deferred(ozstream &archive, const zheader &header, std::size_t initial_size,
+        int compression_level)
+        : archive_(archive),
+          file_(new ozstream::deflated_file())
+    {
+        file_->header = header;
+        file_->compression_level = compression_level;
+        file_->data.resize(initial_size);
+        setp(file_->data.data(), file_->data.data() + file_->data.size());
+    }
+
+    ~zip_streambuf_deferred() override
+    {
+        used_ += static_cast<std::size_t>(pptr() - pbase());
+        file_->data.resize(used_);
+        archive_.submit(std::move(file_));
+    }
+
+protected:
+    int overflow(int c) override
+    {
+        used_ += static_cast<std::size_t>(pptr() - pbase());
+        auto &data = file_->data;
+
+        if (c != traits_type::eof())
+        {
+            if (used_ == data.size())
+            {
+                data.resize(data.size() * 2);
+            }
+
+            data[used_++] = static_cast<char>(c);
+        }
+
+        // the put area only ever covers the unused tail, so pbump never needs
+        // to move past more than int can represent
+        setp(data.data() + used_, data.data() + data.size());
+
+        return traits_type::not_eof(c);
+    }
+
+    int underflow() override
+    {
+        throw xlnt::exception("Attempt to read write only ostream");
+    }
+
+private:
+    ozstream &archive_;
+    std::unique_ptr<ozstream::deflated_file> file_;
+    std::size_t used_ = 0;
+};
+
+ozstream::ozstream(std::ostream &stream, std::size_t buffer_size, std::size_t compression_threads,
+    int compression_level)
+    : destination_stream_(stream),
+      buffer_size_(buffer_size),
+      compression_threads_(std::max(compression_threads, std::size_t(1))),
+      compression_level_(compression_level)
 {
     if (!destination_stream_)
     {
         throw xlnt::exception("bad zip stream");
     }
+
+    if (buffer_size_ < min_buffer_size || compression_level_ < -1 || compression_level_ > 9)
+    {
+        throw xlnt::invalid_parameter();
+    }
+
+    if (compression_threads_ > 1)
+    {
+        pool_.reset(new deflate_pool(compression_threads_));
+    }
 }
 
 ozstream::~ozstream()
 {
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+        // errors can't be reported from here, call close first to see them
+    }
+}
+
+void ozstream::close()
+{
+    if (closed_) return;
+    closed_ = true;
+
+    if (pool_)
+    {
+        write_compressed(0);
+        pool_.reset();
+    }
+
     // Write all file headers
     auto final_position = destination_stream_.tellp();
 
@@ -478,22 +779,120 @@ ozstream::~ozstream()
 
 std::unique_ptr<std::streambuf> ozstream::open(const path &filename)
 {
+    if (closed_)
+    {
+        throw xlnt::exception("archive is closed");
+    }
+
     zheader header;
     header.filename = filename.string();
+
+    if (pool_)
+    {
+        // keep a few finished files queued per worker so that none of them
+        // waits on the writer, without buffering the whole archive
+        write_compressed(2 * compression_threads_);
+
+        return std::unique_ptr<std::streambuf>(new zip_streambuf_deferred(*this, header, buffer_size_, compression_level_));
+    }
+
     file_headers_.push_back(header);
-    auto buffer = new zip_streambuf_compress(&file_headers_.back(), destination_stream_);
+    auto buffer = new zip_streambuf_compress(&file_headers_.back(), destination_stream_, buffer_size_, compression_level_);
 
     return std::unique_ptr<zip_streambuf_compress>(buffer);
 }
 
-izstream::izstream(std::istream &stream)
-    : source_stream_(stream)
+void ozstream::submit(std::unique_ptr<deflated_file> file)
+{
+    auto &pool = *pool_;
+
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.queue.push_back(file.get());
+    }
+
+    pool.pending.push_back(std::move(file));
+    pool.work_available.notify_one();
+}
+
+void ozstream::write_compressed(std::size_t pending_limit)
+{
+    auto &pool = *pool_;
+
+    while (!pool.pending.empty())
+    {
+        auto &next = *pool.pending.front();
+
+        {
+            std::unique_lock<std::mutex> lock(pool.mutex);
+
+            if (!next.done)
+            {
+                if (pool.pending.size() <= pending_limit) return;
+                pool.work_done.wait(lock, [&next]() { return next.done; });
+            }
+        }
+
+        auto file = std::move(pool.pending.front());
+        pool.pending.pop_front();
+
+        if (file->error)
+        {
+            std::rethrow_exception(file->error);
+        }
+
+        file->header.header_offset = static_cast<std::uint32_t>(destination_stream_.tellp());
+        write_header(file->header, destination_stream_, false);
+        destination_stream_.write(file->data.data(), static_cast<std::streamsize>(file->data.size()));
+        file_headers_.push_back(file->header);
+    }
+}
+
+std::size_t ozstream::buffer_size() const
+{
+    return buffer_size_;
+}
+
+std::size_t ozstream::compression_threads() const
+{
+    return compression_threads_;
+}
+
+int ozstream::compression_level() const
+{
+    return compression_level_;
+}
+
+izstream::izstream(std::istream &stream, std::size_t buffer_size)
+    : source_stream_(stream),
+      buffer_size_(buffer_size)
 {
     if (!stream)
     {
         throw xlnt::exception("Invalid file handle");
     }
 
+    if (buffer_size_ < min_buffer_size)
+    {
+        throw xlnt::invalid_parameter();
+    }
+
+    read_central_header();
+}
+
+izstream::izstream(const std::uint8_t *data, std::size_t size, std::size_t buffer_size)
+    : data_(data),
+      size_(size),
+      memory_buffer_(new memory_istreambuf(data, size)),
+      memory_stream_(new std::istream(memory_buffer_.get())),
+      source_stream_(*memory_stream_),
+      buffer_size_(buffer_size)
+{
+    if (buffer_size_ < min_buffer_size)
+    {
+        throw xlnt::invalid_parameter();
+    }
+
     read_central_header();
 }
 
@@ -598,19 +997,227 @@ std::unique_ptr<std::streambuf> izstream::open(const path &filename) const
     }
 
     auto header = file_headers_.at(filename.string());
+
+    if (memory_backed())
+    {
+        auto data = reinterpret_cast<const char *>(entry_data(header));
+        return std::unique_ptr<zip_streambuf_decompress>(
+            new zip_streambuf_decompress(source_stream_, header, buffer_size_, data));
+    }
+
     source_stream_.seekg(header.header_offset);
-    auto buffer = new zip_streambuf_decompress(source_stream_, header);
+    auto buffer = new zip_streambuf_decompress(source_stream_, header, buffer_size_);
+
+    return std::unique_ptr<zip_streambuf_decompress>(buffer);
+}
+
+const std::uint8_t *izstream::entry_data(const zheader &header) const
+{
+    // the local header has a fixed size part followed by a filename and extra
+    // field which may differ in length from the ones in the central header
+    const auto fixed_header_size = std::size_t(30);
+
+    if (std::size_t(header.header_offset) + fixed_header_size > size_)
+    {
+        throw xlnt::exception("couldn't read ZIP entry, possibly corrupted");
+    }
+
+    const auto local_header = data_ + header.header_offset;
+
+    if (local_header[0] != 0x50 || local_header[1] != 0x4b || local_header[2] != 0x03 || local_header[3] != 0x04)
+    {
+        throw xlnt::exception("missing local header signature");
+    }
+
+    const auto filename_length = static_cast<std::size_t>(local_header[26] | (local_header[27] << 8));
+    const auto extra_length = static_cast<std::size_t>(local_header[28] | (local_header[29] << 8));
+    const auto data_offset = header.header_offset + fixed_header_size + filename_length + extra_length;
+    const auto stored_size = header.compression_type == 0 ? header.uncompressed_size : header.compressed_size;
+
+    if (data_offset + stored_size > size_)
+    {
+        throw xlnt::exception("couldn't read ZIP entry, possibly corrupted");
+    }
+
+    return data_ + data_offset;
+}
+
+std::vector<std::uint8_t> izstream::read_stored(const path &filename) const
+{
+    if (!has_file(filename))
+    {
+        throw xlnt::exception("file not found");
+    }
+
+    const auto &header = file_headers_.at(filename.string());
+    source_stream_.seekg(header.header_offset);
+
+    // the local header has a fixed size part followed by a filename and extra
+    // field which may differ in length from the ones in the central header
+    const auto fixed_header_size = std::size_t(30);
+    std::vector<std::uint8_t> stored(fixed_header_size);
+    source_stream_.read(reinterpret_cast<char *>(stored.data()), static_cast<std::streamsize>(fixed_header_size));
+
+    const auto filename_length = static_cast<std::size_t>(stored[26] | (stored[27] << 8));
+    const auto extra_length = static_cast<std::size_t>(stored[28] | (stored[29] << 8));
+    const auto remaining = filename_length + extra_length + header.compressed_size;
+
+    stored.resize(fixed_header_size + remaining);
+    source_stream_.read(reinterpret_cast<char *>(stored.data() + fixed_header_size), static_cast<std::streamsize>(remaining));
+
+    if (static_cast<std::size_t>(source_stream_.gcount()) != remaining)
+    {
+        throw xlnt::exception("couldn't read ZIP entry, possibly corrupted");
+    }
+
+    return stored;
+}
+
+std::unique_ptr<std::streambuf> izstream::open_stored(const path &filename, std::istream &stored) const
+{
+    if (!has_file(filename))
+    {
+        throw xlnt::exception("file not found");
+    }
+
+    auto header = file_headers_.at(filename.string());
+    auto buffer = new zip_streambuf_decompress(stored, header, buffer_size_);
 
     return std::unique_ptr<zip_streambuf_decompress>(buffer);
 }
 
 std::string izstream::read(const path &filename) const
 {
-    auto buffer = open(filename);
-    std::istream stream(buffer.get());
-    auto bytes = to_vector(stream);
+    auto result = std::string(uncompressed_size(filename), '\0');
+    result.resize(read_into(filename, reinterpret_cast<std::uint8_t *>(&result[0]), result.size()));
+
+    return result;
+}
+
+std::size_t izstream::uncompressed_size(const path &filename) const
+{
+    if (!has_file(filename))
+    {
+        throw xlnt::exception("file not found");
+    }
+
+    return file_headers_.at(filename.string()).uncompressed_size;
+}
+
+std::size_t izstream::read_into(const path &filename, std::uint8_t *destination, std::size_t capacity) const
+{
+    if (!has_file(filename))
+    {
+        throw xlnt::exception("file not found");
+    }
+
+    const auto &header = file_headers_.at(filename.string());
+
+    if (capacity < header.uncompressed_size)
+    {
+        throw xlnt::invalid_parameter();
+    }
+
+    const auto memory_data = memory_backed() ? entry_data(header) : nullptr;
+
+    if (memory_data == nullptr)
+    {
+        source_stream_.seekg(header.header_offset);
+        read_header(source_stream_, false);
+    }
+
+    if (header.compression_type == 0 && memory_data != nullptr)
+    {
+        std::copy(memory_data, memory_data + header.uncompressed_size, destination);
+        return header.uncompressed_size;
+    }
+
+    if (header.compression_type == 0) // stored
+    {
+        source_stream_.read(reinterpret_cast<char *>(destination), static_cast<std::streamsize>(header.uncompressed_size));
+
+        if (static_cast<std::size_t>(source_stream_.gcount()) != header.uncompressed_size)
+        {
+            throw xlnt::exception("couldn't read ZIP entry, possibly corrupted");
+        }
+
+        return header.uncompressed_size;
+    }
+
+    if (header.compression_type != 8) // deflate
+    {
+        throw xlnt::exception("unsupported compression type, should be DEFLATE or uncompressed");
+    }
+
+    z_stream strm;
+    strm.zalloc = nullptr;
+    strm.zfree = nullptr;
+    strm.opaque = nullptr;
+    strm.avail_in = 0;
+    strm.next_in = nullptr;
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+    if (inflateInit2(&strm, -MAX_WBITS) != Z_OK)
+#pragma clang diagnostic pop
+    {
+        throw xlnt::exception("couldn't inflate ZIP, possibly corrupted");
+    }
+
+    // the output goes straight to destination, only the input from a stream is buffered
+    std::vector<char> in(memory_data == nullptr ? std::min(buffer_size_, std::size_t(header.compressed_size) + 1) : 0);
+    std::size_t total_read = 0;
+
+    if (memory_data != nullptr)
+    {
+        strm.next_in = memory_data;
+        strm.avail_in = header.compressed_size;
+        total_read = header.compressed_size;
+    }
+
+    strm.next_out = destination;
+    strm.avail_out = static_cast<unsigned int>(std::min(capacity, std::size_t(header.uncompressed_size)));
+
+    int ret = Z_OK;
+
+    while (ret != Z_STREAM_END)
+    {
+        if (strm.avail_in == 0 && memory_data == nullptr)
+        {
+            source_stream_.read(in.data(),
+                static_cast<std::streamsize>(std::min(in.size(), header.compressed_size - total_read)));
+            strm.avail_in = static_cast<unsigned int>(source_stream_.gcount());
+            strm.next_in = reinterpret_cast<Bytef *>(in.data());
+            total_read += strm.avail_in;
+        }
+
+        ret = inflate(&strm, Z_NO_FLUSH);
+
+        if (ret != Z_OK && ret != Z_STREAM_END)
+        {
+            break;
+        }
+    }
+
+    const auto total_out = static_cast<std::size_t>(strm.total_out);
+    inflateEnd(&strm);
+
+    if (ret != Z_STREAM_END)
+    {
+        throw xlnt::exception("couldn't inflate ZIP, possibly corrupted");
+    }
+
+    return total_out;
+}
+
+std::size_t izstream::buffer_size() const
+{
+    return buffer_size_;
+}
 
-    return std::string(bytes.begin(), bytes.end());
+bool izstream::memory_backed() const
+{
+    return data_ != nullptr;
 }
 
 std::vector<path> izstream::files() const
@@ -48,6 +48,12 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 namespace xlnt {
 namespace detail {
 
+/// <summary>
+/// The default size in bytes of each of the input and output buffers used when
+/// compressing or decompressing a file in an archive.
+/// </summary>
+constexpr std::size_t default_zstream_buffer_size = 64 * 1024;
+
 /// <summary>
 /// A structure representing the header that occurs before each compressed file in a ZIP
 /// archive and again at the end of the file with more information.
@@ -77,22 +83,72 @@ class XLNT_API ozstream
 public:
     /// <summary>
     /// Construct a new zip_file_writer which writes a ZIP archive to the given stream.
+    /// Each file opened for writing uses input and output buffers of buffer_size bytes.
+    /// If compression_threads is greater than one, each file is collected in memory
+    /// and compressed on one of that many worker threads once its streambuf is
+    /// destroyed, so that it can be compressed while the next file is written.
+    /// compression_level is a zlib level from 1 (fastest) to 9 (smallest), -1 for
+    /// the zlib default or 0 to store files without compressing them.
     /// </summary>
-    ozstream(std::ostream &stream);
+    ozstream(std::ostream &stream, std::size_t buffer_size = default_zstream_buffer_size,
+        std::size_t compression_threads = 1, int compression_level = -1);
 
     /// <summary>
-    /// Destructor.
+    /// Destructor. Calls close if it hasn't been called yet.
     /// </summary>
     virtual ~ozstream();
 
     /// <summary>
     /// Returns a pointer to a streambuf which compresses the data it receives.
+    /// Only one file may be open at a time.
     /// </summary>
     std::unique_ptr<std::streambuf> open(const path &file);
 
+    /// <summary>
+    /// Waits for files which are still being compressed, writes them to the
+    /// stream and finishes the archive with its central directory. Rethrows
+    /// the first error raised while compressing a file.
+    /// </summary>
+    void close();
+
+    /// <summary>
+    /// Returns the size of the buffers used by streambufs returned from open.
+    /// </summary>
+    std::size_t buffer_size() const;
+
+    /// <summary>
+    /// Returns the number of threads used to compress files.
+    /// </summary>
+    std::size_t compression_threads() const;
+
+    /// <summary>
+    /// Returns the compression level used for files written to the archive.
+    /// </summary>
+    int compression_level() const;
+
 private:
+    friend class zip_streambuf_deferred;
+    struct deflated_file;
+    struct deflate_pool;
+
+    /// <summary>
+    /// Hands a file collected by a deferred streambuf to the worker threads.
+    /// </summary>
+    void submit(std::unique_ptr<deflated_file> file);
+
+    /// <summary>
+    /// Writes compressed files to the stream in the order they were opened,
+    /// waiting until at most pending_limit files remain unwritten.
+    /// </summary>
+    void write_compressed(std::size_t pending_limit);
+
     std::vector<zheader> file_headers_;
     std::ostream &destination_stream_;
+    std::size_t buffer_size_;
+    std::size_t compression_threads_;
+    int compression_level_;
+    std::unique_ptr<deflate_pool> pool_;
+    bool closed_ = false;
 };
 
 /// <summary>
@@ -104,8 +160,18 @@ class XLNT_API izstream
 public:
     /// <summary>
     /// Construct a new zip_file_reader which reads a ZIP archive from the given stream.
+    /// Each file opened for reading uses input and output buffers of buffer_size bytes.
+    /// </summary>
+    izstream(std::istream &stream, std::size_t buffer_size = default_zstream_buffer_size);
+
+    /// <summary>
+    /// Construct a new zip_file_reader which reads a ZIP archive held in memory, such
+    /// as a memory mapped file, which must outlive this object. Compressed data is
+    /// inflated straight from that memory and stored data is returned without copying.
+    /// Unlike the stream based reader, open and read_into may be called from
+    /// different threads at the same time.
     /// </summary>
-    izstream(std::istream &stream);
+    izstream(const std::uint8_t *data, std::size_t size, std::size_t buffer_size = default_zstream_buffer_size);
 
     /// <summary>
     /// Destructor.
@@ -118,10 +184,40 @@ public:
     std::unique_ptr<std::streambuf> open(const path &file) const;
 
     /// <summary>
-    ///
+    /// Copies the local header and still compressed data of file out of the archive
+    /// so that it can be inflated later by open_stored without using the source stream.
+    /// </summary>
+    std::vector<std::uint8_t> read_stored(const path &file) const;
+
+    /// <summary>
+    /// Returns a streambuf which inflates file from stored, a stream over bytes
+    /// previously returned by read_stored. Unlike open, this doesn't touch the
+    /// source stream, so different files can be inflated on different threads.
+    /// </summary>
+    std::unique_ptr<std::streambuf> open_stored(const path &file, std::istream &stored) const;
+
+    /// <summary>
+    /// Decompresses all of file into a string.
     /// </summary>
     std::string read(const path &file) const;
 
+    /// <summary>
+    /// Returns the size of file once decompressed, as recorded in the archive.
+    /// </summary>
+    std::size_t uncompressed_size(const path &file) const;
+
+    /// <summary>
+    /// Decompresses all of file directly into destination, which must have room
+    /// for at least uncompressed_size(file) bytes, without going through a streambuf.
+    /// Returns the number of bytes written.
+    /// </summary>
+    std::size_t read_into(const path &file, std::uint8_t *destination, std::size_t capacity) const;
+
+    /// <summary>
+    /// Returns the size of the buffers used by streambufs returned from open.
+    /// </summary>
+    std::size_t buffer_size() const;
+
     /// <summary>
     ///
     /// </summary>
@@ -132,21 +228,49 @@ public:
     /// </summary>
     bool has_file(const path &filename) const;
 
+    /// <summary>
+    /// Returns true if this archive reads from memory rather than from a stream.
+    /// </summary>
+    bool memory_backed() const;
+
 private:
     /// <summary>
     ///
     /// </summary>
     bool read_central_header();
 
+    /// <summary>
+    /// Returns a pointer to the compressed data of the file described by header
+    /// in a memory backed archive.
+    /// </summary>
+    const std::uint8_t *entry_data(const zheader &header) const;
+
     /// <summary>
     ///
     /// </summary>
     std::unordered_map<std::string, zheader> file_headers_;
 
+    /// <summary>
+    /// The start and size of the archive when it's read from memory.
+    /// </summary>
+    const std::uint8_t *data_ = nullptr;
+    std::size_t size_ = 0;
+
+    /// <summary>
+    /// A stream over data_ used for the central directory when reading from memory.
+    /// </summary>
+    std::unique_ptr<std::streambuf> memory_buffer_;
+    std::unique_ptr<std::istream> memory_stream_;
+
     /// <summary>
     ///
     /// </summary>
     std::istream &source_stream_;
+
+    /// <summary>
+    /// The size of the input and output buffers of each opened file.
+    /// </summary>
+    std::size_t buffer_size_;
 };
 
 } // namespace detail
@@ -38,7 +38,9 @@ format::format(detail::format_impl *d)
 
 void format::clear_style()
 {
-    d_->style.reset();
+    auto updated = *d_;
+    updated.style.reset();
+    d_->parent->format_impls.assign(*d_, updated);
 }
 
 format format::style(const xlnt::style &new_style)
@@ -49,7 +51,10 @@ format format::style(const xlnt::style &new_style)
 
 format format::style(const std::string &new_style)
 {
-    d_->style = new_style;
+    auto updated = *d_;
+    updated.style = new_style;
+    d_->parent->format_impls.assign(*d_, updated);
+
     return format(d_);
 }
 
@@ -145,7 +150,7 @@ xlnt::number_format format::number_format() const
         }
     }
 
-    return xlnt::number_format();
+    return number_format::general();
 }
 
 format format::number_format(const xlnt::number_format &new_number_format, std::optional<bool> applied)
@@ -154,8 +159,7 @@ format format::number_format(const xlnt::number_format &new_number_format, std::
 
     if (!copy.has_id())
     {
-        copy.id(d_->parent->next_custom_number_format_id());
-        d_->parent->number_formats.push_back(copy);
+        copy.id(d_->parent->custom_number_format_id(copy));
     }
 
     d_ = d_->parent->find_or_create_with(d_, copy, applied);
@@ -222,7 +226,9 @@ bool format::pivot_button() const
 
 void format::pivot_button(bool show)
 {
-    d_->pivot_button_ = show;
+    auto updated = *d_;
+    updated.pivot_button_ = show;
+    d_->parent->format_impls.assign(*d_, updated);
 }
 
 bool format::quote_prefix() const
@@ -232,7 +238,9 @@ bool format::quote_prefix() const
 
 void format::quote_prefix(bool quote)
 {
-    d_->quote_prefix_ = quote;
+    auto updated = *d_;
+    updated.quote_prefix_ = quote;
+    d_->parent->format_impls.assign(*d_, updated);
 }
 
 } // namespace xlnt
@@ -25,6 +25,8 @@
 #include <algorithm>
 #include <cctype>
 #include <unordered_map>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include <xlnt/styles/number_format.hpp>
@@ -240,7 +242,8 @@ number_format::number_format(std::size_t id)
 }
 
 number_format::number_format(const std::string &format_string)
-    : format_string_(format_string)
+    : format_string_(format_string),
+      parsed_(std::make_shared<detail::parsed_number_format>())
 {
 }
 
@@ -272,6 +275,7 @@ std::string number_format::format_string() const
 void number_format::format_string(const std::string &format_string)
 {
     format_string_ = format_string;
+    parsed_ = std::make_shared<detail::parsed_number_format>();
     id_ = 0;
 
     for (const auto &pair : builtin_formats())
@@ -287,6 +291,7 @@ void number_format::format_string(const std::string &format_string)
 void number_format::format_string(const std::string &format_string, std::size_t id)
 {
     format_string_ = format_string;
+    parsed_ = std::make_shared<detail::parsed_number_format>();
     id_ = id;
 }
 
@@ -310,39 +315,60 @@ std::size_t number_format::id() const
     return id_.value();
 }
 
-bool number_format::is_date_format() const
+const detail::parsed_number_format &number_format::parsed() const
 {
-    detail::number_format_parser p(format_string_);
-    p.parse();
-    auto parsed = p.result();
+    auto &parsed = *parsed_;
+
+    if (parsed.parsed.load(std::memory_order_acquire))
+    {
+        return parsed;
+    }
 
-    bool any_datetime = false;
-    bool any_timedelta = false;
+    std::lock_guard<std::mutex> lock(parsed.mutex);
 
-    for (const auto &section : parsed)
+    if (!parsed.parsed.load(std::memory_order_relaxed))
     {
-        if (section.is_datetime)
-        {
-            any_datetime = true;
-        }
+        // an invalid format string throws here and again on each use, as before
+        detail::number_format_parser p(format_string_);
+        p.parse();
+        parsed.codes = p.result();
 
-        if (section.is_timedelta)
+        bool any_datetime = false;
+        bool any_timedelta = false;
+
+        for (const auto &section : parsed.codes)
         {
-            any_timedelta = true;
+            if (section.is_datetime)
+            {
+                any_datetime = true;
+            }
+
+            if (section.is_timedelta)
+            {
+                any_timedelta = true;
+            }
         }
+
+        parsed.is_date = any_datetime && !any_timedelta;
+        parsed.parsed.store(true, std::memory_order_release);
     }
 
-    return any_datetime && !any_timedelta;
+    return parsed;
+}
+
+bool number_format::is_date_format() const
+{
+    return parsed().is_date;
 }
 
 std::string number_format::format(const std::string &text) const
 {
-    return detail::number_formatter(format_string_, calendar::windows_1900).format_text(text);
+    return detail::number_formatter(parsed().codes, calendar::windows_1900).format_text(text);
 }
 
 std::string number_format::format(double number, calendar base_date) const
 {
-    return detail::number_formatter(format_string_, base_date).format_number(number);
+    return detail::number_formatter(parsed().codes, base_date).format_number(number);
 }
 
 bool number_format::operator==(const number_format &other) const
@@ -26,12 +26,14 @@
 #include <xlnt/cell/cell.hpp>
 #include <xlnt/packaging/manifest.hpp>
 #include <xlnt/utils/optional.hpp>
+#include <xlnt/workbook/cell_batch.hpp>
 #include <xlnt/workbook/streaming_workbook_reader.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
+#include <detail/implementations/cell_impl.hpp>
 #include <detail/implementations/workbook_impl.hpp>
+#include <detail/serialization/mapped_file.hpp>
 #include <detail/serialization/open_stream.hpp>
-#include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/xlsx_consumer.hpp>
 
 namespace xlnt {
@@ -49,13 +51,23 @@ void streaming_workbook_reader::close()
 {
     if (consumer_)
     {
+        parser_.reset(nullptr);
+        part_stream_.reset(nullptr);
+        part_stream_buffer_.reset(nullptr);
         consumer_.reset(nullptr);
         stream_buffer_.reset(nullptr);
+        mapping_.reset(nullptr);
     }
 }
 
 bool streaming_workbook_reader::has_cell()
 {
+    if (pending_cell_)
+    {
+        pending_cell_ = false;
+        return true;
+    }
+
     return consumer_->has_cell();
 }
 
@@ -64,6 +76,93 @@ cell streaming_workbook_reader::read_cell()
     return consumer_->read_cell();
 }
 
+std::size_t streaming_workbook_reader::read_batch(cell_batch &batch, std::size_t column_count, std::size_t max_rows)
+{
+    batch.rows = 0;
+    batch.columns.resize(column_count);
+
+    for (auto &column : batch.columns)
+    {
+        column.types.clear();
+        column.numbers.clear();
+        column.validity.clear();
+        column.string_offsets.assign(1, 0);
+        column.strings.clear();
+    }
+
+    auto append_row = [&batch]() {
+        for (auto &column : batch.columns)
+        {
+            column.types.push_back(cell_type::empty);
+            column.numbers.push_back(0.0);
+            column.string_offsets.push_back(column.string_offsets.back());
+
+            if (batch.rows % 8 == 0)
+            {
+                column.validity.push_back(0);
+            }
+        }
+
+        ++batch.rows;
+    };
+
+    while (max_rows > 0 && has_cell())
+    {
+        const auto &impl = *consumer_->streaming_cell_;
+
+        if (batch.rows == 0)
+        {
+            batch.first_row = impl.row_;
+        }
+
+        const auto row = static_cast<std::size_t>(impl.row_ - batch.first_row);
+
+        if (row >= max_rows)
+        {
+            pending_cell_ = true;
+            break;
+        }
+
+        while (batch.rows <= row)
+        {
+            append_row();
+        }
+
+        const auto column_index = static_cast<std::size_t>(impl.column_.index - 1);
+        if (column_index >= column_count || impl.type_ == cell_type::empty) continue;
+
+        auto &column = batch.columns[column_index];
+        column.types[row] = impl.type_;
+        column.validity[row / 8] = static_cast<std::uint8_t>(column.validity[row / 8] | (1 << (row % 8)));
+
+        switch (impl.type_)
+        {
+        case cell_type::boolean:
+        case cell_type::date:
+        case cell_type::number:
+            column.numbers[row] = impl.value_numeric_;
+            break;
+
+        case cell_type::shared_string:
+            column.strings.append(workbook_->shared_strings(static_cast<std::size_t>(impl.value_numeric_)).plain_text());
+            column.string_offsets.back() = static_cast<std::uint32_t>(column.strings.size());
+            break;
+
+        case cell_type::error:
+        case cell_type::formula_string:
+        case cell_type::inline_string:
+            column.strings.append(impl.value_text()->plain_text());
+            column.string_offsets.back() = static_cast<std::uint32_t>(column.strings.size());
+            break;
+
+        case cell_type::empty:
+            break;
+        }
+    }
+
+    return batch.rows;
+}
+
 bool streaming_workbook_reader::has_worksheet(const std::string &name)
 {
     auto titles = sheet_titles();
@@ -108,6 +207,7 @@ void streaming_workbook_reader::begin_worksheet(const std::string &title)
         throw xlnt::exception("sheet not found");
     }
 
+    pending_cell_ = false;
     consumer_->read_worksheet_begin(worksheet_rel_id_);
 }
 
@@ -118,16 +218,15 @@ worksheet streaming_workbook_reader::end_worksheet()
 
 void streaming_workbook_reader::open(const std::vector<std::uint8_t> &data)
 {
-    stream_buffer_.reset(new detail::vector_istreambuf(data));
-    stream_.reset(new std::istream(stream_buffer_.get()));
-    open(*stream_);
+    close();
+    workbook_.reset(new workbook());
+    consumer_.reset(new detail::xlsx_consumer(*workbook_));
+    consumer_->open(data.data(), data.size());
 }
 
 void streaming_workbook_reader::open(const std::string &filename)
 {
-    stream_.reset(new std::ifstream());
-    xlnt::detail::open_stream(static_cast<std::ifstream &>(*stream_), filename);
-    open(*stream_);
+    open(xlnt::path(filename));
 }
 
 #ifdef _MSC_VER
@@ -141,9 +240,22 @@ void streaming_workbook_reader::open(const std::wstring &filename)
 
 void streaming_workbook_reader::open(const xlnt::path &filename)
 {
-    stream_.reset(new std::ifstream());
-    xlnt::detail::open_stream(static_cast<std::ifstream &>(*stream_), filename.string());
-    open(*stream_);
+    close();
+    mapping_.reset(new detail::mapped_file(filename));
+
+    if (mapping_->data() == nullptr)
+    {
+        mapping_.reset(nullptr);
+        stream_.reset(new std::ifstream());
+        xlnt::detail::open_stream(static_cast<std::ifstream &>(*stream_), filename.string());
+        open(*stream_);
+
+        return;
+    }
+
+    workbook_.reset(new workbook());
+    consumer_.reset(new detail::xlsx_consumer(*workbook_));
+    consumer_->open(mapping_->data(), mapping_->size());
 }
 
 void streaming_workbook_reader::open(std::istream &stream)
@@ -26,10 +26,12 @@
 #include <xlnt/cell/cell.hpp>
 #include <xlnt/packaging/manifest.hpp>
 #include <xlnt/utils/optional.hpp>
+#include <xlnt/workbook/save_options.hpp>
 #include <xlnt/workbook/streaming_workbook_writer.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
 #include <detail/implementations/cell_impl.hpp>
+#include <detail/implementations/workbook_impl.hpp>
 #include <detail/implementations/worksheet_impl.hpp>
 #include <detail/serialization/open_stream.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
@@ -43,33 +45,63 @@ streaming_workbook_writer::streaming_workbook_writer()
 
 streaming_workbook_writer::~streaming_workbook_writer()
 {
-    close();
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+        // errors can only be reported by calling close explicitly
+    }
 }
 
 void streaming_workbook_writer::close()
 {
     if (producer_)
     {
-        producer_.reset(nullptr);
+        // released first so that a failure part way through doesn't lead to
+        // a second attempt from the destructor
+        auto producer = std::move(producer_);
+
+        if (producer->current_worksheet_ == nullptr)
+        {
+            producer->begin_worksheet(workbook_->active_sheet());
+        }
+
+        producer->close();
+        producer.reset();
+
+        stream_.reset(nullptr);
         stream_buffer_.reset(nullptr);
     }
 }
 
 cell streaming_workbook_writer::add_cell(const cell_reference &ref)
 {
+    if (producer_->current_worksheet_ == nullptr)
+    {
+        producer_->begin_worksheet(workbook_->active_sheet());
+    }
+
     return producer_->add_cell(ref);
 }
 
 worksheet streaming_workbook_writer::add_worksheet(const std::string &title)
 {
-    return producer_->add_worksheet(title);
+    // the first worksheet takes the place of the default one
+    auto ws = producer_->current_worksheet_ == nullptr
+        ? workbook_->active_sheet()
+        : workbook_->create_sheet();
+    ws.title(title);
+
+    producer_->begin_worksheet(ws);
+
+    return ws;
 }
 
 void streaming_workbook_writer::open(std::vector<std::uint8_t> &data)
 {
-    stream_buffer_.reset(new detail::vector_ostreambuf(data));
-    stream_.reset(new std::ostream(stream_buffer_.get()));
-    open(*stream_);
+    open(data, save_options());
 }
 
 void streaming_workbook_writer::open(const std::string &filename)
@@ -89,20 +121,39 @@ void streaming_workbook_writer::open(const std::wstring &filename)
 #endif
 
 void streaming_workbook_writer::open(const xlnt::path &filename)
+{
+    open(filename, save_options());
+}
+
+void streaming_workbook_writer::open(std::ostream &stream)
+{
+    open(stream, save_options());
+}
+
+void streaming_workbook_writer::open(std::vector<std::uint8_t> &data, const save_options &options)
+{
+    stream_buffer_.reset(new detail::vector_ostreambuf(data));
+    stream_.reset(new std::ostream(stream_buffer_.get()));
+    open(*stream_, options);
+}
+
+void streaming_workbook_writer::open(const xlnt::path &filename, const save_options &options)
 {
     stream_.reset(new std::ofstream());
     xlnt::detail::open_stream(static_cast<std::ofstream &>(*stream_), filename.string());
-    open(*stream_);
+    open(*stream_, options);
 }
 
-void streaming_workbook_writer::open(std::ostream &stream)
+void streaming_workbook_writer::open(std::ostream &stream, const save_options &options)
 {
     workbook_.reset(new workbook());
-    producer_.reset(new detail::xlsx_producer(*workbook_));
+
+    // style ids are written with each cell, so they mustn't be renumbered
+    // by a collection after the cell has gone
+    workbook_->d_->stylesheet_.value().garbage_collection_enabled = false;
+
+    producer_.reset(new detail::xlsx_producer(*workbook_, options));
     producer_->open(stream);
-    producer_->current_worksheet_ = new detail::worksheet_impl(workbook_.get(), 1, "Sheet1");
-    producer_->current_cell_ = new detail::cell_impl();
-    producer_->current_cell_->parent_ = producer_->current_worksheet_;
 }
 
 } // namespace xlnt
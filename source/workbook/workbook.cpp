@@ -26,6 +26,7 @@
 #include <array>
 #include <fstream>
 #include <functional>
+#include <mutex>
 #include <set>
 
 #include <xlnt/cell/cell.hpp>
@@ -42,6 +43,8 @@
 #include <xlnt/utils/exceptions.hpp>
 #include <xlnt/utils/path.hpp>
 #include <xlnt/utils/variant.hpp>
+#include <xlnt/workbook/load_options.hpp>
+#include <xlnt/workbook/save_options.hpp>
 #include <xlnt/workbook/metadata_property.hpp>
 #include <xlnt/workbook/named_range.hpp>
 #include <xlnt/workbook/theme.hpp>
@@ -57,6 +60,7 @@
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/implementations/worksheet_impl.hpp>
 #include <detail/serialization/excel_thumbnail.hpp>
+#include <detail/serialization/mapped_file.hpp>
 #include <detail/serialization/open_stream.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/xlsx_consumer.hpp>
@@ -257,6 +261,33 @@ std::string content_type(xlnt::relationship_type type)
     default_case("application/xml");
 }
 
+// Reads an XLSX package straight from memory, falling back to a stream over
+// the same memory when it turns out to be encrypted with the default password.
+void load_from_memory(xlnt::workbook &wb, const std::uint8_t *data, std::size_t size,
+    const xlnt::load_options &options)
+{
+    wb.clear();
+    xlnt::detail::xlsx_consumer consumer(wb, options);
+
+    try
+    {
+        consumer.read(data, size);
+    }
+    catch (xlnt::exception &e)
+    {
+        if (e.what() == std::string("xlnt::exception : encrypted xlsx, password required"))
+        {
+            xlnt::detail::memory_istreambuf data_buffer(data, size);
+            std::istream data_stream(&data_buffer);
+            consumer.read(data_stream, "VelvetSweatshop");
+        }
+        else
+        {
+            throw;
+        }
+    }
+}
+
 } // namespace
 
 namespace xlnt {
@@ -890,9 +921,14 @@ range workbook::named_range(const std::string &name)
 }
 
 void workbook::load(std::istream &stream)
+{
+    load(stream, load_options());
+}
+
+void workbook::load(std::istream &stream, const load_options &options)
 {
     clear();
-    detail::xlsx_consumer consumer(*this);
+    detail::xlsx_consumer consumer(*this, options);
 
     try
     {
@@ -913,15 +949,18 @@ void workbook::load(std::istream &stream)
 }
 
 void workbook::load(const std::vector<std::uint8_t> &data)
+{
+    load(data, load_options());
+}
+
+void workbook::load(const std::vector<std::uint8_t> &data, const load_options &options)
 {
     if (data.size() < 22) // the shortest ZIP file is 22 bytes
     {
         throw xlnt::exception("file is empty or malformed");
     }
 
-    xlnt::detail::vector_istreambuf data_buffer(data);
-    std::istream data_stream(&data_buffer);
-    load(data_stream);
+    load_from_memory(*this, data.data(), data.size(), options);
 }
 
 void workbook::load(const std::string &filename)
@@ -931,6 +970,22 @@ void workbook::load(const std::string &filename)
 
 void workbook::load(const path &filename)
 {
+    load(filename, load_options());
+}
+
+void workbook::load(const path &filename, const load_options &options)
+{
+    if (options.memory_map)
+    {
+        detail::mapped_file mapping(filename);
+
+        if (mapping.data() != nullptr && mapping.size() >= 22)
+        {
+            load_from_memory(*this, mapping.data(), mapping.size(), options);
+            return;
+        }
+    }
+
     std::ifstream file_stream;
     open_stream(file_stream, filename.string());
 
@@ -939,7 +994,7 @@ void workbook::load(const path &filename)
         throw xlnt::exception("file not found " + filename.string());
     }
 
-    load(file_stream);
+    load(file_stream, options);
 }
 
 void workbook::load(const std::string &filename, const std::string &password)
@@ -948,6 +1003,21 @@ void workbook::load(const std::string &filename, const std::string &password)
 }
 
 void workbook::load(const path &filename, const std::string &password)
+{
+    load(filename, password, load_options());
+}
+
+void workbook::load(const std::vector<std::uint8_t> &data, const std::string &password)
+{
+    load(data, password, load_options());
+}
+
+void workbook::load(std::istream &stream, const std::string &password)
+{
+    load(stream, password, load_options());
+}
+
+void workbook::load(const path &filename, const std::string &password, const load_options &options)
 {
     std::ifstream file_stream;
     open_stream(file_stream, filename.string());
@@ -957,25 +1027,25 @@ void workbook::load(const path &filename, const std::string &password)
         throw xlnt::exception("file not found " + filename.string());
     }
 
-    return load(file_stream, password);
+    return load(file_stream, password, options);
 }
 
-void workbook::load(const std::vector<std::uint8_t> &data, const std::string &password)
+void workbook::load(const std::vector<std::uint8_t> &data, const std::string &password, const load_options &options)
 {
     if (data.size() < 22) // the shortest ZIP file is 22 bytes
     {
         throw xlnt::exception("file is empty or malformed");
     }
 
-    xlnt::detail::vector_istreambuf data_buffer(data);
+    xlnt::detail::memory_istreambuf data_buffer(data.data(), data.size());
     std::istream data_stream(&data_buffer);
-    load(data_stream, password);
+    load(data_stream, password, options);
 }
 
-void workbook::load(std::istream &stream, const std::string &password)
+void workbook::load(std::istream &stream, const std::string &password, const load_options &options)
 {
     clear();
-    detail::xlsx_consumer consumer(*this);
+    detail::xlsx_consumer consumer(*this, options);
     consumer.read(stream, password);
 }
 
@@ -1019,16 +1089,39 @@ void workbook::save(const path &filename, const std::string &password) const
 
 void workbook::save(std::ostream &stream) const
 {
-    detail::xlsx_producer producer(*this);
-    producer.write(stream);
+    save(stream, save_options());
 }
 
 void workbook::save(std::ostream &stream, const std::string &password) const
 {
+    collect_deferred_style_garbage();
+
     detail::xlsx_producer producer(*this);
     producer.write(stream, password);
 }
 
+void workbook::save(std::vector<std::uint8_t> &data, const save_options &options) const
+{
+    xlnt::detail::vector_ostreambuf data_buffer(data);
+    std::ostream data_stream(&data_buffer);
+    save(data_stream, options);
+}
+
+void workbook::save(const path &filename, const save_options &options) const
+{
+    std::ofstream file_stream;
+    open_stream(file_stream, filename.string());
+    save(file_stream, options);
+}
+
+void workbook::save(std::ostream &stream, const save_options &options) const
+{
+    collect_deferred_style_garbage();
+
+    detail::xlsx_producer producer(*this, options);
+    producer.write(stream);
+}
+
 #ifdef _MSC_VER
 void workbook::save(const std::wstring &filename) const
 {
@@ -1191,6 +1284,9 @@ void workbook::clear()
 
 bool workbook::operator==(const workbook &rhs) const
 {
+    read_pending_shared_strings();
+    rhs.read_pending_shared_strings();
+
     return *d_ == *rhs.d_;
 }
 
@@ -1334,6 +1430,36 @@ bool workbook::known_fonts_enabled() const
     return d_->stylesheet_.value().known_fonts_enabled;
 }
 
+void workbook::defer_style_garbage_collection()
+{
+    d_->stylesheet_.value().garbage_collection_deferred = true;
+}
+
+void workbook::resume_style_garbage_collection()
+{
+    d_->stylesheet_.value().garbage_collection_deferred = false;
+    garbage_collect_styles();
+}
+
+bool workbook::style_garbage_collection_deferred() const
+{
+    return d_->stylesheet_.value().garbage_collection_deferred;
+}
+
+void workbook::garbage_collect_styles()
+{
+    d_->stylesheet_.value().garbage_collect();
+}
+
+void workbook::collect_deferred_style_garbage() const
+{
+    if (d_->stylesheet_.has_value() && d_->stylesheet_.value().garbage_collection_deferred)
+    {
+        // otherwise the unused records would be written out
+        d_->stylesheet_.value().garbage_collect();
+    }
+}
+
 void workbook::clear_formats()
 {
     apply_to_cells([](cell c) { c.clear_format(); });
@@ -1380,7 +1506,18 @@ const rich_text &workbook::shared_strings(std::size_t index) const
 {
     if (index < d_->shared_strings_values_.size())
     {
-        return d_->shared_strings_values_.at(index);
+        if (d_->shared_strings_lazy_)
+        {
+            std::lock_guard<std::mutex> lock(d_->shared_strings_mutex_);
+
+            if (d_->shared_strings_source_ && d_->shared_strings_pending_[index])
+            {
+                detail::xlsx_consumer(const_cast<workbook &>(*this)).read_shared_string(index);
+            }
+        }
+
+        // parsing other strings later doesn't move this one
+        return d_->shared_strings_values_[index];
     }
 
     static rich_text empty;
@@ -1389,33 +1526,66 @@ const rich_text &workbook::shared_strings(std::size_t index) const
 
 std::vector<rich_text> &workbook::shared_strings()
 {
+    read_pending_shared_strings();
     return d_->shared_strings_values_;
 }
 
 const std::vector<rich_text> &workbook::shared_strings() const
 {
+    read_pending_shared_strings();
     return d_->shared_strings_values_;
 }
 
+void workbook::read_pending_shared_strings() const
+{
+    if (!d_->shared_strings_lazy_) return;
+
+    std::lock_guard<std::mutex> lock(d_->shared_strings_mutex_);
+
+    if (d_->shared_strings_source_)
+    {
+        detail::xlsx_consumer(const_cast<workbook &>(*this)).read_shared_strings();
+    }
+}
+
 std::size_t workbook::add_shared_string(const rich_text &shared, bool allow_duplicates)
 {
     register_workbook_part(relationship_type::shared_string_table);
+    read_pending_shared_strings();
 
     if (!allow_duplicates)
     {
-        auto it = d_->shared_strings_ids_.find(shared);
+        const auto existing = d_->shared_strings_table_.find(d_->shared_strings_values_, shared);
 
-        if (it != d_->shared_strings_ids_.end())
+        if (existing != detail::shared_string_table::npos)
         {
-            return it->second;
+            return existing;
         }
     }
 
-    auto sz = d_->shared_strings_ids_.size();
-    d_->shared_strings_ids_[shared] = sz;
+    const auto index = d_->shared_strings_values_.size();
     d_->shared_strings_values_.push_back(shared);
+    d_->shared_strings_table_.insert(d_->shared_strings_values_, index);
+
+    return index;
+}
+
+std::size_t workbook::add_shared_string(const std::string &shared, bool allow_duplicates)
+{
+    if (!allow_duplicates)
+    {
+        register_workbook_part(relationship_type::shared_string_table);
+        read_pending_shared_strings();
+
+        const auto existing = d_->shared_strings_table_.find(d_->shared_strings_values_, shared);
+
+        if (existing != detail::shared_string_table::npos)
+        {
+            return existing;
+        }
+    }
 
-    return sz;
+    return add_shared_string(rich_text(shared), allow_duplicates);
 }
 
 bool workbook::contains(const std::string &sheet_title) const
@@ -25,6 +25,7 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <stdexcept>
 
 #include <xlnt/cell/cell.hpp>
 #include <xlnt/cell/cell_reference.hpp>
@@ -201,19 +202,9 @@ const workbook &worksheet::workbook() const
 
 void worksheet::garbage_collect()
 {
-    auto cell_iter = d_->cell_map_.begin();
-
-    while (cell_iter != d_->cell_map_.end())
-    {
-        if (xlnt::cell(&cell_iter->second).garbage_collectible())
-        {
-            cell_iter = d_->cell_map_.erase(cell_iter);
-        }
-        else
-        {
-            ++cell_iter;
-        }
-    }
+    d_->cell_map_.erase_if([](const detail::cell_impl &impl) {
+        return impl.is_garbage_collectible();
+    });
 }
 
 void worksheet::id(std::size_t id)
@@ -383,21 +374,26 @@ cell_reference worksheet::active_cell() const
 cell worksheet::cell(const cell_reference &reference)
 {
     auto match = d_->cell_map_.find(reference);
-    if (match == d_->cell_map_.end())
+    if (match == nullptr)
     {
         auto impl = detail::cell_impl();
         impl.parent_ = d_;
         impl.column_ = reference.column_index();
         impl.row_ = reference.row();
 
-        match = d_->cell_map_.emplace(reference, impl).first;
+        match = d_->cell_map_.emplace(std::move(impl)).first;
     }
-    return xlnt::cell(&match->second);
+    return xlnt::cell(match);
 }
 
 const cell worksheet::cell(const cell_reference &reference) const
 {
-    return xlnt::cell(&d_->cell_map_.at(reference));
+    auto match = d_->cell_map_.find(reference);
+    if (match == nullptr)
+    {
+        throw std::out_of_range("cell " + reference.to_string() + " doesn't exist");
+    }
+    return xlnt::cell(match);
 }
 
 cell worksheet::cell(xlnt::column_t column, row_t row)
@@ -412,8 +408,7 @@ const cell worksheet::cell(xlnt::column_t column, row_t row) const
 
 bool worksheet::has_cell(const cell_reference &reference) const
 {
-    const auto cell = d_->cell_map_.find(reference);
-    return cell != d_->cell_map_.cend();
+    return d_->cell_map_.find(reference) != nullptr;
 }
 
 bool worksheet::has_row_properties(row_t row) const
@@ -458,14 +453,7 @@ column_t worksheet::lowest_column() const
         return constants::min_column();
     }
 
-    auto lowest = constants::max_column();
-
-    for (auto &cell : d_->cell_map_)
-    {
-        lowest = std::min(lowest, cell.first.column());
-    }
-
-    return lowest;
+    return d_->cell_map_.lowest_column();
 }
 
 column_t worksheet::lowest_column_or_props() const
@@ -492,14 +480,7 @@ row_t worksheet::lowest_row() const
         return constants::min_row();
     }
 
-    auto lowest = constants::max_row();
-
-    for (auto &cell : d_->cell_map_)
-    {
-        lowest = std::min(lowest, cell.first.row());
-    }
-
-    return lowest;
+    return d_->cell_map_.lowest_row();
 }
 
 row_t worksheet::lowest_row_or_props() const
@@ -521,14 +502,12 @@ row_t worksheet::lowest_row_or_props() const
 
 row_t worksheet::highest_row() const
 {
-    auto highest = constants::min_row();
-
-    for (auto &cell : d_->cell_map_)
+    if (d_->cell_map_.empty())
     {
-        highest = std::max(highest, cell.first.row());
+        return constants::min_row();
     }
 
-    return highest;
+    return d_->cell_map_.highest_row();
 }
 
 row_t worksheet::highest_row_or_props() const
@@ -550,14 +529,12 @@ row_t worksheet::highest_row_or_props() const
 
 column_t worksheet::highest_column() const
 {
-    auto highest = constants::min_column();
-
-    for (auto &cell : d_->cell_map_)
+    if (d_->cell_map_.empty())
     {
-        highest = std::max(highest, cell.first.column());
+        return constants::min_column();
     }
 
-    return highest;
+    return d_->cell_map_.highest_column();
 }
 
 column_t worksheet::highest_column_or_props() const
@@ -610,15 +587,13 @@ range_reference worksheet::calculate_dimension(bool skip_null) const
     column_t max_col = constants::min_column();
     row_t min_row = min_row_prop;
     row_t max_row = max_row_prop;
-    for (auto &c : d_->cell_map_)
+    if (skip_null)
     {
-        if(skip_null){
-            min_col = std::min(min_col, c.second.column_);
-            min_row = std::min(min_row, c.second.row_);
-        }
-        max_col = std::max(max_col, c.second.column_);
-        max_row = std::max(max_row, c.second.row_);
+        min_col = std::min(min_col, d_->cell_map_.lowest_column());
+        min_row = std::min(min_row, d_->cell_map_.lowest_row());
     }
+    max_col = std::max(max_col, d_->cell_map_.highest_column());
+    max_row = std::max(max_row, d_->cell_map_.highest_row());
     return range_reference(min_col, min_row, max_col, max_row);
 }
 
@@ -766,17 +741,7 @@ void worksheet::clear_cell(const cell_reference &ref)
 
 void worksheet::clear_row(row_t row)
 {
-    for (auto it = d_->cell_map_.begin(); it != d_->cell_map_.end();)
-    {
-        if (it->first.row() == row)
-        {
-            it = d_->cell_map_.erase(it);
-        }
-        else
-        {
-            ++it;
-        }
-    }
+    d_->cell_map_.erase_row(row);
     d_->row_properties_.erase(row);
     // TODO: garbage collect newly unreferenced resources such as styles?
 }
@@ -815,17 +780,15 @@ void worksheet::move_cells(std::uint32_t min_index, std::uint32_t amount, row_or
 
     std::vector<detail::cell_impl> cells_to_move;
 
-    auto cell_iter = d_->cell_map_.cbegin();
-    while (cell_iter != d_->cell_map_.cend())
-    {
+    d_->cell_map_.erase_if([&](const detail::cell_impl &impl) {
         std::uint32_t current_index;
         switch (row_or_col)
         {
         case row_or_col_t::row:
-            current_index = cell_iter->first.row();
+            current_index = impl.row_;
             break;
         case row_or_col_t::column:
-            current_index = cell_iter->first.column().index;
+            current_index = impl.column_.index;
             break;
         default:
             throw xlnt::unhandled_switch_case();
@@ -833,7 +796,7 @@ void worksheet::move_cells(std::uint32_t min_index, std::uint32_t amount, row_or
 
         if (current_index >= min_index) // extract cells to be moved
         {
-            auto cell = cell_iter->second;
+            auto cell = impl;
             if (row_or_col == row_or_col_t::row)
             {
                 cell.row_ = reverse ? cell.row_ - amount : cell.row_ + amount;
@@ -844,21 +807,16 @@ void worksheet::move_cells(std::uint32_t min_index, std::uint32_t amount, row_or
             }
 
             cells_to_move.push_back(cell);
-            cell_iter = d_->cell_map_.erase(cell_iter);
+            return true;
         }
-        else if (reverse && current_index >= min_index - amount) // delete destination cells
-        {
-            cell_iter = d_->cell_map_.erase(cell_iter);
-        }
-        else // skip other cells
-        {
-            ++cell_iter;
-        }
-    }
+
+        // delete destination cells and skip other cells
+        return reverse && current_index >= min_index - amount;
+    });
 
     for (auto &cell : cells_to_move)
     {
-        d_->cell_map_[cell_reference(cell.column_, cell.row_)] = cell;
+        d_->cell_map_.insert_or_assign(cell);
     }
 
     if (row_or_col == row_or_col_t::row)
@@ -969,13 +927,14 @@ bool worksheet::compare(const worksheet &other, bool reference) const
 
     for (auto &cell : d_->cell_map_)
     {
-        if (other.d_->cell_map_.find(cell.first) == other.d_->cell_map_.end())
+        auto other_impl = other.d_->cell_map_.find(cell_reference(cell.column_, cell.row_));
+        if (other_impl == nullptr)
         {
             return false;
         }
 
-        xlnt::cell this_cell(&cell.second);
-        xlnt::cell other_cell(&other.d_->cell_map_[cell.first]);
+        xlnt::cell this_cell(&cell);
+        xlnt::cell other_cell(other_impl);
 
         if (this_cell.data_type() != other_cell.data_type())
         {
@@ -38,6 +38,7 @@ public:
         register_test(test_runs);
         register_test(test_phonetic_runs);
         register_test(test_phonetic_properties);
+        register_test(test_hash);
     }
 
     void test_operators()
@@ -142,5 +143,30 @@ public:
         xlnt_assert_equals(rt.phonetic_properties().has_type(), true);
         xlnt_assert_equals(rt.phonetic_properties().has_alignment(), true);
     }
+
+    void test_hash()
+    {
+        xlnt::rich_text_hash hash;
+
+        xlnt_assert_equals(hash(xlnt::rich_text("text")), hash(xlnt::rich_text("text")));
+        xlnt_assert_equals(hash(xlnt::rich_text("text")), hash(std::string("text")));
+        xlnt_assert(xlnt::rich_text("text") == std::string("text"));
+
+        // the same text in a different font or split differently hashes differently
+        xlnt::font bold;
+        bold.bold(true);
+        xlnt_assert_differs(hash(xlnt::rich_text("text", bold)), hash(xlnt::rich_text("text")));
+        xlnt_assert(xlnt::rich_text("text", bold) != std::string("text"));
+
+        xlnt::rich_text split;
+        split.add_run(xlnt::rich_text_run{"te", {}, false});
+        split.add_run(xlnt::rich_text_run{"xt", {}, false});
+        xlnt_assert_differs(hash(split), hash(xlnt::rich_text("text")));
+
+        xlnt::rich_text swapped;
+        swapped.add_run(xlnt::rich_text_run{"xt", {}, false});
+        swapped.add_run(xlnt::rich_text_run{"te", {}, false});
+        xlnt_assert_differs(hash(split), hash(swapped));
+    }
 };
 static rich_text_test_suite x{};
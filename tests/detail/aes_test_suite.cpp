@@ -0,0 +1,149 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <detail/cryptography/aes.hpp>
+#include <helpers/test_suite.hpp>
+
+namespace {
+
+std::vector<std::uint8_t> from_hex(const std::string &hex)
+{
+    std::vector<std::uint8_t> bytes;
+
+    for (std::size_t i = 0; i + 1 < hex.size(); i += 2)
+    {
+        bytes.push_back(static_cast<std::uint8_t>(std::stoul(hex.substr(i, 2), nullptr, 16)));
+    }
+
+    return bytes;
+}
+
+} // namespace
+
+class aes_test_suite : public test_suite
+{
+public:
+    aes_test_suite()
+    {
+        register_test(test_ecb_known_answers);
+        register_test(test_cbc_known_answers);
+        register_test(test_hardware_matches_portable);
+    }
+
+    // FIPS-197 appendix C, run with and without the processor's AES instructions
+    void test_ecb_known_answers()
+    {
+        const auto plaintext = from_hex("00112233445566778899aabbccddeeff");
+        const std::vector<std::pair<std::string, std::string>> vectors = {
+            {"000102030405060708090a0b0c0d0e0f", "69c4e0d86a7b0430d8cdb78070b4c55a"},
+            {"000102030405060708090a0b0c0d0e0f1011121314151617", "dda97ca4864cdfe06eaf70a0ec0d7191"},
+            {"000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", "8ea2b7ca516745bfeafc49904b496089"}};
+
+        for (auto hardware : {false, true})
+        {
+            xlnt::detail::aes_allow_hardware(hardware);
+
+            for (const auto &vector : vectors)
+            {
+                const auto key = from_hex(vector.first);
+                const auto ciphertext = from_hex(vector.second);
+
+                xlnt_assert(xlnt::detail::aes_ecb_encrypt(plaintext, key) == ciphertext);
+                xlnt_assert(xlnt::detail::aes_ecb_decrypt(ciphertext, key) == plaintext);
+            }
+        }
+
+        xlnt::detail::aes_allow_hardware(true);
+    }
+
+    // NIST SP 800-38A F.2.1 and F.2.5, four blocks so the wide decryption path is used
+    void test_cbc_known_answers()
+    {
+        const auto iv = from_hex("000102030405060708090a0b0c0d0e0f");
+        const auto plaintext = from_hex(
+            "6bc1bee22e409f96e93d7e117393172a"
+            "ae2d8a571e03ac9c9eb76fac45af8e51"
+            "30c81c46a35ce411e5fbc1191a0a52ef"
+            "f69f2445df4f9b17ad2b417be66c3710");
+        const std::vector<std::pair<std::string, std::string>> vectors = {
+            {"2b7e151628aed2a6abf7158809cf4f3c",
+                "7649abac8119b246cee98e9b12e9197d"
+                "5086cb9b507219ee95db113a917678b2"
+                "73bed6b8e3c1743b7116e69e22229516"
+                "3ff1caa1681fac09120eca307586e1a7"},
+            {"603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4",
+                "f58c4c04d6e5f1ba779eabfb5f7bfbd6"
+                "9cfc4e967edb808d679f777bc6702c7d"
+                "39f23369a9d9bacfa530e26304231461"
+                "b2eb05e2c39be9fcda6c19078c6a9d1b"}};
+
+        for (auto hardware : {false, true})
+        {
+            xlnt::detail::aes_allow_hardware(hardware);
+
+            for (const auto &vector : vectors)
+            {
+                const auto key = from_hex(vector.first);
+                const auto ciphertext = from_hex(vector.second);
+
+                xlnt_assert(xlnt::detail::aes_cbc_encrypt(plaintext, key, iv) == ciphertext);
+                xlnt_assert(xlnt::detail::aes_cbc_decrypt(ciphertext, key, iv) == plaintext);
+            }
+        }
+
+        xlnt::detail::aes_allow_hardware(true);
+    }
+
+    void test_hardware_matches_portable()
+    {
+        // an odd number of blocks exercises both the four block and single block loops
+        std::vector<std::uint8_t> data(16 * 23);
+        for (std::size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = static_cast<std::uint8_t>(i * 7 + 3);
+        }
+
+        const auto key = from_hex("603deb1015ca71be2b73aef0857d77811f352c073b6108d7");
+        const auto iv = from_hex("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff");
+
+        xlnt::detail::aes_allow_hardware(false);
+        const auto ecb = xlnt::detail::aes_ecb_encrypt(data, key);
+        const auto cbc = xlnt::detail::aes_cbc_encrypt(data, key, iv);
+
+        xlnt::detail::aes_allow_hardware(true);
+        xlnt_assert(xlnt::detail::aes_ecb_encrypt(data, key) == ecb);
+        xlnt_assert(xlnt::detail::aes_cbc_encrypt(data, key, iv) == cbc);
+        xlnt_assert(xlnt::detail::aes_ecb_decrypt(ecb, key) == data);
+        xlnt_assert(xlnt::detail::aes_cbc_decrypt(cbc, key, iv) == data);
+
+        std::vector<std::uint8_t> output(data.size());
+        xlnt::detail::aes_cbc_decrypt(cbc.data() + 16, cbc.size() - 16, key, cbc.data(), output.data());
+        xlnt_assert(std::equal(output.begin(), output.end() - 16, data.begin() + 16));
+    }
+};
+static aes_test_suite x;
@@ -37,6 +37,7 @@ public:
     {
         register_test(test_basic);
         register_test(test_simple_format);
+        register_test(test_copies_share_parsed_format);
         register_test(test_bad_date_format);
         register_test(test_simple_date);
         register_test(test_short_month);
@@ -155,6 +156,35 @@ public:
         xlnt_assert_equals(formatted, "zero0");
     }
 
+    void test_copies_share_parsed_format()
+    {
+        xlnt::number_format original("0.00");
+        xlnt_assert_equals(original.format(1.234, xlnt::calendar::windows_1900), "1.23");
+        xlnt_assert(!original.is_date_format());
+
+        // copies reuse the parsed code until they're given a new format string
+        auto copy = original;
+        copy.id(170);
+        xlnt_assert_equals(copy.format(2.5, xlnt::calendar::windows_1900), "2.50");
+
+        copy.format_string("yyyy-mm-dd");
+        xlnt_assert(copy.is_date_format());
+        xlnt_assert(!original.is_date_format());
+        xlnt_assert_equals(original.format(1.234, xlnt::calendar::windows_1900), "1.23");
+
+        // a format that doesn't parse isn't remembered as parsed
+        xlnt::number_format invalid("[x]");
+        auto invalid_copy = invalid;
+        xlnt_assert_throws(invalid.is_date_format(), std::runtime_error);
+        xlnt_assert_throws(invalid_copy.format(1.0, xlnt::calendar::windows_1900), std::runtime_error);
+
+        auto date_format = xlnt::number_format::date_yyyymmdd2();
+        xlnt_assert(date_format.is_date_format());
+        xlnt_assert(xlnt::number_format::date_yyyymmdd2().is_date_format());
+        xlnt_assert(!xlnt::number_format::date_time5().format_string().empty());
+        xlnt_assert(xlnt::number_format::date_time5().is_date_format());
+    }
+
     void test_bad_date_format()
     {
         auto date = xlnt::date(2016, 6, 18);
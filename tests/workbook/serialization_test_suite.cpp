@@ -21,9 +21,13 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <thread>
 
 #include <xlnt/xlnt.hpp>
+#include <detail/cryptography/xlsx_crypto_consumer.hpp>
 #include <helpers/path_helper.hpp>
 #include <helpers/temporary_file.hpp>
 #include <helpers/test_suite.hpp>
@@ -44,6 +48,7 @@ public:
         register_test(test_decrypt_libre_office);
         register_test(test_decrypt_standard);
         register_test(test_decrypt_numbers);
+        register_test(test_decrypt_concurrently);
         register_test(test_read_unicode_filename);
         register_test(test_comments);
         register_test(test_read_hyperlink);
@@ -60,12 +65,33 @@ public:
         register_test(test_round_trip_rw_print_settings);
         register_test(test_round_trip_rw_advanced_properties);
         register_test(test_round_trip_rw_custom_heights_widths);
+        register_test(test_round_trip_rw_pipelined_sheet_data);
+        register_test(test_load_worksheets_concurrently);
+        register_test(test_load_hyperlinks_concurrently);
+        register_test(test_zip_buffer_sizes);
+        register_test(test_load_memory_mapped);
+        register_test(test_load_shared_strings_lazily);
+        register_test(test_load_selected_sheets);
+        register_test(test_load_sheet_ranges);
+        register_test(test_load_values_only);
+        register_test(test_load_sheet_data_tokenized);
+        register_test(test_load_part_with_wrong_size);
+        register_test(test_load_truncated_part);
+        register_test(test_save_sparse_worksheet);
+        register_test(test_save_shared_string_count);
+        register_test(test_load_reuses_stylesheet_records);
+        register_test(test_save_sheet_data_directly);
+        register_test(test_save_parallel_compression);
+        register_test(test_save_compression_levels);
         register_test(test_round_trip_rw_encrypted_agile);
         register_test(test_round_trip_rw_encrypted_libre);
         register_test(test_round_trip_rw_encrypted_standard);
         register_test(test_round_trip_rw_encrypted_numbers);
         register_test(test_streaming_read);
+        register_test(test_streaming_read_matches_load);
+        register_test(test_streaming_read_batch);
         register_test(test_streaming_write);
+        register_test(test_streaming_write_rows);
         register_test(test_load_save_german_locale);
         register_test(test_Issue445_inline_str_load);
         register_test(test_Issue445_inline_str_streaming_read);
@@ -338,6 +364,40 @@ public:
         xlnt_assert_throws_nothing(wb.load(path, "secret"));
     }
 
+    void test_decrypt_concurrently()
+    {
+        const std::vector<std::pair<std::string, std::string>> files = {
+            {"5_encrypted_agile.xlsx", "secret"},
+            {"6_encrypted_libre.xlsx", u8"\u043F\u0430\u0440\u043E\u043B\u044C"}, // u8"пароль"
+            {"7_encrypted_standard.xlsx", "password"},
+            {"8_encrypted_numbers.xlsx", "secret"}};
+
+        for (const auto &file : files)
+        {
+            std::vector<std::uint8_t> encrypted;
+            {
+                std::ifstream stream(path_helper::test_file(file.first).string(), std::ios::binary);
+                encrypted = xlnt::detail::to_vector(stream);
+            }
+
+            const auto serial = xlnt::detail::decrypt_xlsx(encrypted, file.second);
+
+            for (auto threads : {2, 3, 64})
+            {
+                xlnt_assert(xlnt::detail::decrypt_xlsx(encrypted, file.second,
+                                static_cast<std::size_t>(threads))
+                    == serial);
+            }
+
+            xlnt::load_options options;
+            options.decryption_threads = 0;
+
+            xlnt::workbook wb;
+            xlnt_assert_throws(wb.load(path_helper::test_file(file.first), "incorrect", options), xlnt::exception);
+            xlnt_assert_throws_nothing(wb.load(path_helper::test_file(file.first), file.second, options));
+        }
+    }
+
     void test_read_unicode_filename()
     {
 #ifdef _MSC_VER
@@ -572,9 +632,14 @@ public:
     /// write the workbook back to memory, then ensure that the contents of the two files are equivalent.
     /// </summary>
     bool round_trip_matches_rw(const xlnt::path &source)
+    {
+        return round_trip_matches_rw(source, xlnt::load_options());
+    }
+
+    bool round_trip_matches_rw(const xlnt::path &source, const xlnt::load_options &options)
     {
         xlnt::workbook source_workbook;
-        source_workbook.load(source);
+        source_workbook.load(source, options);
 
         std::vector<std::uint8_t> destination;
         source_workbook.save(destination);
@@ -654,7 +719,888 @@ public:
     {
         xlnt_assert(round_trip_matches_rw(path_helper::test_file("13_custom_heights_widths.xlsx")));
     }
+
+    void test_round_trip_rw_pipelined_sheet_data()
+    {
+        xlnt::load_options options;
+        options.pipeline_sheet_data = true;
+        options.sheet_data_chunk_rows = 1;
+
+        xlnt_assert(round_trip_matches_rw(path_helper::test_file("4_every_style.xlsx"), options));
+        xlnt_assert(round_trip_matches_rw(path_helper::test_file("11_print_settings.xlsx"), options));
+
+        options.sheet_data_chunk_rows = 0;
+        xlnt_assert(round_trip_matches_rw(path_helper::test_file("13_custom_heights_widths.xlsx"), options));
+    }
+
+    void test_load_worksheets_concurrently()
+    {
+        xlnt::load_options options;
+        options.worksheet_threads = 3;
+
+        for (const auto &file : {"4_every_style.xlsx", "10_comments_hyperlinks_formulae.xlsx",
+                 "18_formulae.xlsx", "19_defined_names.xlsx", "20_active_sheet.xlsx"})
+        {
+            xlnt::workbook sequential;
+            sequential.load(path_helper::test_file(file));
+            std::vector<std::uint8_t> sequential_data;
+            sequential.save(sequential_data);
+
+            xlnt::workbook concurrent;
+            concurrent.load(path_helper::test_file(file), options);
+            std::vector<std::uint8_t> concurrent_data;
+            concurrent.save(concurrent_data);
+
+            xlnt_assert_equals(concurrent.sheet_count(), sequential.sheet_count());
+            xlnt_assert_equals(concurrent.active_sheet().title(), sequential.active_sheet().title());
+            xlnt_assert(xml_helper::xlsx_archives_match(sequential_data, concurrent_data));
+        }
+
+        // loading merged cells clears the cells under them, which adds to the
+        // shared strings and drops formulae while other worksheets are being read
+        xlnt::workbook merged;
+
+        for (auto i = 0; i < 6; ++i)
+        {
+            auto ws = i == 0 ? merged.active_sheet() : merged.create_sheet();
+
+            for (xlnt::row_t row = 1; row <= 40; row += 2)
+            {
+                const auto reference = xlnt::range_reference(1, row, 4, row + 1);
+                ws.merge_cells(reference);
+
+                for (auto cells : ws.range(reference))
+                {
+                    for (auto cell : cells)
+                    {
+                        if (cell.column().index % 3 == 0)
+                        {
+                            cell.formula("=A" + std::to_string(row));
+                        }
+                        else
+                        {
+                            cell.value("sheet " + std::to_string(i) + " " + cell.reference().to_string());
+                        }
+                    }
+                }
+            }
+        }
+
+        std::vector<std::uint8_t> merged_data;
+        merged.save(merged_data);
+
+        xlnt::workbook sequential;
+        sequential.load(merged_data);
+        std::vector<std::uint8_t> sequential_data;
+        sequential.save(sequential_data);
+
+        xlnt::workbook concurrent;
+        concurrent.load(merged_data, options);
+        std::vector<std::uint8_t> concurrent_data;
+        concurrent.save(concurrent_data);
+
+        xlnt_assert_equals(concurrent.sheet_by_index(5).merged_ranges().size(), 20);
+        xlnt_assert_equals(concurrent.sheet_by_index(5).cell("B40").to_string(), "");
+        xlnt_assert(!concurrent.sheet_by_index(5).cell("C40").has_formula());
+        xlnt_assert(xml_helper::xlsx_archives_match(sequential_data, concurrent_data));
+    }
+
+    void test_load_hyperlinks_concurrently()
+    {
+        // both worksheets set hyperlinks and formulae, which register relationships
+        // in the manifest while the other worksheet is still being read
+        const auto file = path_helper::test_file("10_comments_hyperlinks_formulae.xlsx");
+
+        xlnt::workbook sequential;
+        sequential.load(file);
+
+        xlnt::load_options options;
+        options.worksheet_threads = 2;
+
+        for (int i = 0; i < 20; ++i)
+        {
+            xlnt::workbook concurrent;
+            concurrent.load(file, options);
+            xlnt_assert_equals(concurrent.sheet_count(), sequential.sheet_count());
+
+            for (std::size_t sheet = 0; sheet < sequential.sheet_count(); ++sheet)
+            {
+                auto expected_ws = sequential.sheet_by_index(sheet);
+                auto ws = concurrent.sheet_by_index(sheet);
+
+                for (auto row : expected_ws.rows())
+                {
+                    for (auto cell : row)
+                    {
+                        auto loaded = ws.cell(cell.reference());
+                        xlnt_assert_equals(loaded.has_hyperlink(), cell.has_hyperlink());
+                        xlnt_assert_equals(loaded.has_formula(), cell.has_formula());
+
+                        if (cell.has_hyperlink())
+                        {
+                            xlnt_assert_equals(loaded.hyperlink().url(), cell.hyperlink().url());
+                        }
+                    }
+                }
+            }
+
+            std::vector<std::uint8_t> sequential_data;
+            sequential.save(sequential_data);
+            std::vector<std::uint8_t> concurrent_data;
+            concurrent.save(concurrent_data);
+            xlnt_assert(xml_helper::xlsx_archives_match(sequential_data, concurrent_data));
+        }
+    }
+
+    void test_zip_buffer_sizes()
+    {
+        std::vector<std::uint8_t> data;
+        {
+            std::ifstream file(path_helper::test_file("4_every_style.xlsx").string(), std::ios::binary);
+            data = xlnt::detail::to_vector(file);
+        }
+
+        xlnt::detail::vector_istreambuf source_buffer(data);
+        std::istream source_stream(&source_buffer);
+        xlnt::detail::izstream archive(source_stream);
+        xlnt::detail::izstream small_archive(source_stream, 16);
+
+        xlnt_assert_equals(archive.buffer_size(), xlnt::detail::default_zstream_buffer_size);
+        xlnt_assert_equals(small_archive.buffer_size(), 16);
+        xlnt_assert_throws(xlnt::detail::izstream(source_stream, 4), xlnt::invalid_parameter);
+
+        std::vector<std::uint8_t> rewritten;
+        {
+            xlnt::detail::vector_ostreambuf destination_buffer(rewritten);
+            std::ostream destination_stream(&destination_buffer);
+            xlnt::detail::ozstream small_writer(destination_stream, 16);
+
+            for (const auto &file : archive.files())
+            {
+                const auto contents = archive.read(file);
+
+                auto streamed = small_archive.open(file);
+                std::istream streamed_stream(streamed.get());
+                const auto streamed_contents = xlnt::detail::to_vector(streamed_stream);
+                xlnt_assert_equals(std::string(streamed_contents.begin(), streamed_contents.end()), contents);
+
+                std::vector<std::uint8_t> direct(small_archive.uncompressed_size(file));
+                xlnt_assert_equals(small_archive.read_into(file, direct.data(), direct.size()), contents.size());
+                xlnt_assert_equals(std::string(direct.begin(), direct.end()), contents);
+
+                if (!direct.empty())
+                {
+                    xlnt_assert_throws(archive.read_into(file, direct.data(), direct.size() - 1),
+                        xlnt::invalid_parameter);
+                }
+
+                auto written = small_writer.open(file);
+                std::ostream written_stream(written.get());
+                written_stream << contents;
+            }
+        }
+
+        xlnt_assert(xml_helper::xlsx_archives_match(data, rewritten));
+    }
+
+    void test_load_memory_mapped()
+    {
+        xlnt::load_options streamed;
+        streamed.memory_map = false;
+
+        for (const auto &file : {"4_every_style.xlsx", "19_defined_names.xlsx"})
+        {
+            xlnt::workbook from_mapping;
+            from_mapping.load(path_helper::test_file(file));
+            std::vector<std::uint8_t> mapping_data;
+            from_mapping.save(mapping_data);
+
+            xlnt::workbook from_stream;
+            from_stream.load(path_helper::test_file(file), streamed);
+            std::vector<std::uint8_t> stream_data;
+            from_stream.save(stream_data);
+
+            xlnt_assert(xml_helper::xlsx_archives_match(mapping_data, stream_data));
+        }
+
+        std::vector<std::uint8_t> data;
+        {
+            std::ifstream file(path_helper::test_file("4_every_style.xlsx").string(), std::ios::binary);
+            data = xlnt::detail::to_vector(file);
+        }
+
+        xlnt::detail::vector_istreambuf source_buffer(data);
+        std::istream source_stream(&source_buffer);
+        xlnt::detail::izstream stream_archive(source_stream);
+        xlnt::detail::izstream memory_archive(data.data(), data.size());
+
+        xlnt_assert(!stream_archive.memory_backed());
+        xlnt_assert(memory_archive.memory_backed());
+
+        for (const auto &file : stream_archive.files())
+        {
+            const auto contents = stream_archive.read(file);
+            xlnt_assert_equals(memory_archive.read(file), contents);
+
+            auto streamed = memory_archive.open(file);
+            std::istream streamed_stream(streamed.get());
+            const auto streamed_contents = xlnt::detail::to_vector(streamed_stream);
+            xlnt_assert_equals(std::string(streamed_contents.begin(), streamed_contents.end()), contents);
+        }
+    }
+
+    void test_load_shared_strings_lazily()
+    {
+        xlnt::load_options lazy;
+        lazy.lazy_shared_strings = true;
+
+        for (const auto &file : {"10_comments_hyperlinks_formulae.xlsx", "15_phonetics.xlsx", "excel_test_sheet.xlsx"})
+        {
+            xlnt::workbook eager;
+            eager.load(path_helper::test_file(file));
+
+            xlnt::workbook wb;
+            wb.load(path_helper::test_file(file), lazy);
+
+            // each string is parsed when its cell is read
+            for (auto ws : eager)
+            {
+                auto lazy_ws = wb.sheet_by_title(ws.title());
+
+                for (auto row : ws.rows())
+                {
+                    for (auto cell : row)
+                    {
+                        if (cell.data_type() != xlnt::cell::type::shared_string) continue;
+
+                        xlnt_assert_equals(lazy_ws.cell(cell.reference()).value<xlnt::rich_text>(),
+                            cell.value<xlnt::rich_text>());
+                    }
+                }
+            }
+
+            // and the rest when the whole table is needed
+            xlnt_assert(wb.shared_strings() == eager.shared_strings());
+
+            std::vector<std::uint8_t> eager_data;
+            eager.save(eager_data);
+            std::vector<std::uint8_t> lazy_data;
+            wb.save(lazy_data);
+
+            xlnt_assert(xml_helper::xlsx_archives_match(eager_data, lazy_data));
+        }
+
+        // adding a string finds existing strings which haven't been parsed yet
+        xlnt::workbook eager;
+        eager.load(path_helper::test_file("10_comments_hyperlinks_formulae.xlsx"));
+        const auto last = eager.shared_strings().back().plain_text();
+
+        xlnt::workbook wb;
+        wb.load(path_helper::test_file("10_comments_hyperlinks_formulae.xlsx"), lazy);
+        xlnt_assert_equals(wb.add_shared_string(last), eager.shared_strings().size() - 1);
+        xlnt_assert_equals(wb.shared_strings().size(), eager.shared_strings().size());
+
+        // a const workbook parses strings for several readers at once, and the
+        // strings they haven't read are parsed when the whole table is needed
+        xlnt::workbook partial;
+        partial.load(path_helper::test_file("excel_test_sheet.xlsx"), lazy);
+        const auto &const_partial = partial;
+        xlnt::workbook excel_eager;
+        excel_eager.load(path_helper::test_file("excel_test_sheet.xlsx"));
+        const auto &expected = excel_eager.shared_strings();
+        std::vector<std::thread> readers;
+
+        for (std::size_t first = 0; first < 2; ++first)
+        {
+            readers.emplace_back([&const_partial, &expected, first]() {
+                for (auto index = first; index < expected.size(); index += 3)
+                {
+                    static_cast<void>(const_partial.shared_strings(index));
+                }
+            });
+        }
+
+        for (auto &reader : readers)
+        {
+            reader.join();
+        }
+
+        for (std::size_t index = 0; index < expected.size(); index += 3)
+        {
+            xlnt_assert_equals(const_partial.shared_strings(index), expected[index]);
+        }
+
+        xlnt_assert(const_partial.shared_strings() == expected);
+    }
+
+    void test_load_selected_sheets()
+    {
+        xlnt::load_options options;
+        options.sheet_titles = {"Sheet2"};
+        options.sheet_indices = {3};
+
+        xlnt::workbook wb;
+        wb.load(path_helper::test_file("20_active_sheet.xlsx"), options);
+
+        xlnt_assert_equals(wb.sheet_titles(), std::vector<std::string>({"Sheet2", "Sheet3"}));
+        xlnt_assert_equals(wb.active_sheet().title(), "Sheet2");
+
+        // the sheets which weren't loaded aren't saved either
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+        xlnt::workbook reloaded;
+        reloaded.load(data);
+        xlnt_assert_equals(reloaded.sheet_titles(), wb.sheet_titles());
+
+        options.sheet_titles = {"Sheet1"};
+        options.sheet_indices.clear();
+        wb.load(path_helper::test_file("20_active_sheet.xlsx"), options);
+        xlnt_assert_equals(wb.sheet_titles(), std::vector<std::string>({"Sheet1"}));
+        xlnt_assert_equals(wb.active_sheet().title(), "Sheet1");
+
+        options.sheet_titles = {"Sheet4"};
+        xlnt_assert_throws(wb.load(path_helper::test_file("20_active_sheet.xlsx"), options), xlnt::key_not_found);
+
+        options.sheet_titles.clear();
+        options.sheet_indices = {4};
+        xlnt_assert_throws(wb.load(path_helper::test_file("20_active_sheet.xlsx"), options), xlnt::invalid_parameter);
+    }
+
+    void test_load_sheet_ranges()
+    {
+        xlnt::workbook full;
+        full.load(path_helper::test_file("4_every_style.xlsx"));
+        auto full_ws = full.active_sheet();
+        const auto bounds = xlnt::range_reference("B2:C10");
+
+        xlnt::load_options options;
+        options.sheet_ranges.emplace(full_ws.title(), bounds);
+
+        for (auto pipelined : {false, true})
+        {
+            options.pipeline_sheet_data = pipelined;
+            options.sheet_data_chunk_rows = 1;
+
+            xlnt::workbook wb;
+            wb.load(path_helper::test_file("4_every_style.xlsx"), options);
+            auto ws = wb.active_sheet();
+
+            for (auto row : full_ws.rows())
+            {
+                for (auto cell : row)
+                {
+                    if (!bounds.contains(cell.reference()))
+                    {
+                        xlnt_assert(!ws.has_cell(cell.reference()));
+                        continue;
+                    }
+
+                    xlnt_assert(ws.has_cell(cell.reference()));
+                    xlnt_assert_equals(ws.cell(cell.reference()).to_string(), cell.to_string());
+                }
+            }
+
+            xlnt_assert(!ws.has_row_properties(1));
+            xlnt_assert_equals(ws.calculate_dimension(), bounds);
+        }
+    }
+
+    void test_load_values_only()
+    {
+        xlnt::workbook source;
+        auto source_ws = source.active_sheet();
+        source_ws.cell("A1").value(xlnt::date(2021, 7, 4));
+        source_ws.cell("A2").value(3.5);
+        source_ws.cell("A2").font(xlnt::font().bold(true));
+        source_ws.cell("A3").value("text");
+        source_ws.cell("A3").comment(xlnt::comment("note", "author"));
+        source_ws.cell("A4").formula("=A2*2");
+        source.core_property(xlnt::core_property::title, "values");
+
+        std::vector<std::uint8_t> data;
+        source.save(data);
+
+        xlnt::load_options options;
+        options.values_only = true;
+
+        xlnt::workbook wb;
+        wb.load(data, options);
+        auto ws = wb.active_sheet();
+
+        xlnt_assert(ws.cell("A1").is_date());
+        xlnt_assert_equals(ws.cell("A1").value<xlnt::date>(), xlnt::date(2021, 7, 4));
+        xlnt_assert_equals(ws.cell("A2").value<double>(), 3.5);
+        xlnt_assert(!ws.cell("A2").is_date());
+        xlnt_assert_equals(ws.cell("A3").value<std::string>(), "text");
+        xlnt_assert(!ws.cell("A3").has_comment());
+        xlnt_assert_equals(ws.cell("A4").formula(), "A2*2");
+        xlnt_assert(!wb.has_core_property(xlnt::core_property::title));
+        xlnt_assert(!wb.has_theme());
+
+        // cells read the same as with a full load
+        for (const auto &file : {"4_every_style.xlsx", "10_comments_hyperlinks_formulae.xlsx", "18_formulae.xlsx"})
+        {
+            xlnt::workbook full;
+            full.load(path_helper::test_file(file));
+            xlnt::workbook values;
+            values.load(path_helper::test_file(file), options);
+
+            for (auto full_ws : full)
+            {
+                auto values_ws = values.sheet_by_title(full_ws.title());
+
+                for (auto row : full_ws.rows())
+                {
+                    for (auto cell : row)
+                    {
+                        auto value = values_ws.cell(cell.reference());
+                        xlnt_assert_equals(value.to_string(), cell.to_string());
+                        xlnt_assert_equals(value.has_formula(), cell.has_formula());
+                    }
+                }
+            }
+        }
+    }
     
+    std::vector<std::uint8_t> with_part(const std::vector<std::uint8_t> &data, const std::string &part, const std::string &contents)
+    {
+        xlnt::detail::vector_istreambuf source_buffer(data);
+        std::istream source_stream(&source_buffer);
+        xlnt::detail::izstream archive(source_stream);
+
+        std::vector<std::uint8_t> rewritten;
+        {
+            xlnt::detail::vector_ostreambuf destination_buffer(rewritten);
+            std::ostream destination_stream(&destination_buffer);
+            xlnt::detail::ozstream writer(destination_stream);
+
+            for (const auto &file : archive.files())
+            {
+                auto written = writer.open(file);
+                std::ostream written_stream(written.get());
+                written_stream << (file.string() == part ? contents : archive.read(file));
+            }
+        }
+
+        return rewritten;
+    }
+
+    // sets the compressed or uncompressed size recorded for part in both its local and
+    // central headers, returning how many headers were changed
+    int set_part_size(std::vector<std::uint8_t> &data, const std::string &part, bool compressed, std::uint32_t size)
+    {
+        auto patched = 0;
+
+        for (auto match = std::search(data.begin(), data.end(), part.begin(), part.end()); match != data.end();
+             match = std::search(match + 1, data.end(), part.begin(), part.end()))
+        {
+            const auto position = static_cast<std::size_t>(match - data.begin());
+            const auto is_header = [&](std::size_t header_size, std::uint8_t kind) {
+                return position >= header_size && data[position - header_size] == 'P'
+                    && data[position - header_size + 1] == 'K' && data[position - header_size + 2] == kind;
+            };
+            const auto size_position = is_header(30, 3) ? position - 30 + (compressed ? 18 : 22)
+                : is_header(46, 1)                      ? position - 46 + (compressed ? 20 : 24)
+                                                        : 0;
+
+            if (size_position != 0)
+            {
+                for (std::size_t i = 0; i < 4; ++i)
+                {
+                    data[size_position + i] = static_cast<std::uint8_t>(size >> (8 * i));
+                }
+
+                ++patched;
+            }
+        }
+
+        return patched;
+    }
+
+    void test_load_sheet_data_tokenized()
+    {
+        xlnt::load_options parsed;
+        parsed.tokenize_sheet_data = false;
+
+        for (const auto &file : {"4_every_style.xlsx", "10_comments_hyperlinks_formulae.xlsx",
+                 "13_custom_heights_widths.xlsx", "18_formulae.xlsx", "Issue445_inline_str.xlsx"})
+        {
+            xlnt::workbook expected;
+            expected.load(path_helper::test_file(file), parsed);
+            std::vector<std::uint8_t> expected_data;
+            expected.save(expected_data);
+
+            xlnt::workbook tokenized;
+            tokenized.load(path_helper::test_file(file));
+            std::vector<std::uint8_t> tokenized_data;
+            tokenized.save(tokenized_data);
+
+            xlnt_assert(xml_helper::xlsx_archives_match(expected_data, tokenized_data));
+        }
+
+        xlnt::workbook source;
+        source.active_sheet().cell("A1").value("shared");
+        std::vector<std::uint8_t> source_data;
+        source.save(source_data);
+
+        // the rich inline string in row 3 is left to the XML parser, along with every
+        // row after it, and the comment in row 4 keeps any row from being tokenized
+        const std::string rows =
+            "<row r=\"1\" spans=\"1:4\" ht=\"20.5\" customHeight=\"1\" x14ac:dyDescent=\"0.25\">"
+            "<c r=\"A1\" t=\"inlineStr\"><is><t xml:space=\"preserve\"> a &amp; b &#x263A;&#9731; </t></is></c>"
+            "<c r=\"B1\"><f t=\"shared\" ref=\"B1:B3\" si=\"0\">A2*2</f><v>2</v></c>"
+            "<c r=\"C1\" t=\"str\"><f t=\"array\" ref=\"C1\">\"x\"&amp;\"y\"</f><v>xy</v></c>"
+            "<c r=\"D1\" t=\"s\" s=\"0\"><v>0</v></c></row>\n"
+            "  <row r=\"2\">\n    <c r=\"A2\"><v>1</v></c><c r=\"B2\"><f t=\"shared\" si=\"0\"/><v>4</v></c>"
+            "<c r=\"C2\" t=\"b\"><v>1</v></c><c r=\"D2\" ph=\"1\"/></row>"
+            "<row r=\"3\" hidden=\"1\"><c r=\"A3\" t=\"inlineStr\"><is><r><t>rich</t></r></is></c>"
+            "<c r=\"B3\"><f t=\"shared\" si=\"0\"/></c></row>"
+            "<row r=\"4\"><c r=\"A4\" t=\"e\"><v>#N/A</v></c><c r=\"B4\" t=\"str\">COMMENT<v>5&lt;6</v></c></row>";
+
+        for (const auto &comment : {"", "<!-- 5 -->"})
+        {
+            auto sheet_rows = rows;
+            sheet_rows.replace(sheet_rows.find("COMMENT"), 7, comment);
+
+            const auto sheet = std::string("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+                "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" "
+                "xmlns:mc=\"http://schemas.openxmlformats.org/markup-compatibility/2006\" "
+                "xmlns:x14ac=\"http://schemas.microsoft.com/office/spreadsheetml/2009/9/ac\" mc:Ignorable=\"x14ac\">"
+                "<dimension ref=\"A1:D4\"/><sheetData>") + sheet_rows + "</sheetData></worksheet>";
+            const auto data = with_part(source_data, "xl/worksheets/sheet1.xml", sheet);
+
+            xlnt::workbook expected;
+            expected.load(data, parsed);
+            auto expected_ws = expected.active_sheet();
+
+            for (auto pipelined : {false, true})
+            {
+                xlnt::load_options options;
+                options.pipeline_sheet_data = pipelined;
+                options.sheet_data_chunk_rows = 1;
+
+                xlnt::workbook wb;
+                wb.load(data, options);
+                auto ws = wb.active_sheet();
+
+                xlnt_assert_equals(ws.cell("A1").value<std::string>(), " a & b \xE2\x98\xBA\xE2\x98\x83 ");
+                xlnt_assert_equals(ws.cell("C1").formula(), "\"x\"&\"y\"");
+                xlnt_assert_equals(ws.cell("D1").value<std::string>(), "shared");
+                xlnt_assert_equals(ws.cell("B4").value<std::string>(), "5<6");
+                xlnt_assert_equals(ws.row_properties(1).height.value(), 20.5);
+                xlnt_assert(ws.row_properties(3).hidden);
+
+                for (auto row : expected_ws.rows())
+                {
+                    for (auto cell : row)
+                    {
+                        auto loaded = ws.cell(cell.reference());
+                        xlnt_assert_equals(loaded.data_type(), cell.data_type());
+                        xlnt_assert_equals(loaded.to_string(), cell.to_string());
+                        xlnt_assert_equals(loaded.has_formula(), cell.has_formula());
+                        xlnt_assert_equals(loaded.phonetics_visible(), cell.phonetics_visible());
+
+                        if (cell.has_formula())
+                        {
+                            xlnt_assert_equals(loaded.formula(), cell.formula());
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void test_load_part_with_wrong_size()
+    {
+        xlnt::workbook source;
+        source.active_sheet().cell("A1").value("text");
+        source.active_sheet().cell("B2").value(2);
+        std::vector<std::uint8_t> data;
+        source.save(data);
+
+        // claim that the worksheet is almost 4 GiB once inflated, in both the local
+        // and the central header, which the loader mustn't allocate up front
+        xlnt_assert_equals(set_part_size(data, "xl/worksheets/sheet1.xml", false, 0xffffffff), 2);
+
+        xlnt::workbook wb;
+        wb.load(data);
+        xlnt_assert_equals(wb.active_sheet().cell("A1").value<std::string>(), "text");
+        xlnt_assert_equals(wb.active_sheet().cell("B2").value<int>(), 2);
+    }
+
+    void test_load_truncated_part()
+    {
+        xlnt::workbook source;
+        source.active_sheet().cell("A1").value("text");
+        std::vector<std::uint8_t> data;
+        source.save(data);
+
+        // the deflate stream of the worksheet ends after the compressed size its headers record
+        xlnt_assert_equals(set_part_size(data, "xl/worksheets/sheet1.xml", true, 16), 2);
+
+        const auto read_all = [](std::streambuf &buffer) {
+            while (buffer.sbumpc() != std::char_traits<char>::eof())
+            {
+            }
+        };
+
+        xlnt::detail::vector_istreambuf source_buffer(data);
+        std::istream source_stream(&source_buffer);
+        xlnt::detail::izstream stream_archive(source_stream);
+        xlnt::detail::izstream memory_archive(data.data(), data.size());
+
+        for (auto archive : {&stream_archive, &memory_archive})
+        {
+            xlnt_assert_throws(read_all(*archive->open(xlnt::path("xl/worksheets/sheet1.xml"))), xlnt::exception);
+        }
+    }
+
+    void test_save_sparse_worksheet()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value(1);
+        ws.cell("XFD100000").value(2);
+        ws.cell("C17").value(3);
+        ws.row_properties(40).height = 30;
+
+        // only the cells which exist are visited, not the whole dimension
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::workbook loaded;
+        loaded.load(data);
+        auto loaded_ws = loaded.active_sheet();
+
+        xlnt_assert_equals(loaded_ws.calculate_dimension(), xlnt::range_reference("A1:XFD100000"));
+        xlnt_assert_equals(loaded_ws.cell("A1").value<int>(), 1);
+        xlnt_assert_equals(loaded_ws.cell("XFD100000").value<int>(), 2);
+        xlnt_assert_equals(loaded_ws.cell("C17").value<int>(), 3);
+        xlnt_assert_equals(loaded_ws.row_properties(40).height.value(), 30.0);
+        xlnt_assert_equals(loaded_ws.row_properties(1).spans.value(), "1:1");
+        xlnt_assert_equals(loaded_ws.row_properties(17).spans.value(), "3:3");
+        xlnt_assert_equals(loaded_ws.row_properties(100000).spans.value(), "16384:16384");
+    }
+
+    std::string saved_part(xlnt::workbook &wb, const std::string &part)
+    {
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::detail::vector_istreambuf data_buffer(data);
+        std::istream data_stream(&data_buffer);
+        xlnt::detail::izstream archive(data_stream);
+
+        return archive.read(xlnt::path(part));
+    }
+
+    void test_save_shared_string_count()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value("one");
+        ws.cell("A2").value("two");
+        ws.cell("A3").value("one");
+        ws.cell("B1").value("three");
+        ws.cell("B2").value("four");
+        ws.cell("C1").value("five");
+
+        ws.cell("B1").value(3);
+        ws.cell("B2").clear_value();
+        ws.clear_cell("C1");
+        ws.cell("D1").value(ws.cell("A1"));
+        wb.copy_sheet(ws);
+
+        // four string cells on each sheet, counted without scanning either of them
+        xlnt_assert_differs(saved_part(wb, "xl/sharedStrings.xml").find(" count=\"8\""), std::string::npos);
+
+        wb.remove_sheet(wb.sheet_by_index(1));
+        ws.delete_rows(1, 1);
+        xlnt_assert_differs(saved_part(wb, "xl/sharedStrings.xml").find(" count=\"2\""), std::string::npos);
+
+        xlnt::workbook loaded;
+        loaded.load(path_helper::test_file("10_comments_hyperlinks_formulae.xlsx"));
+        std::size_t expected = 0;
+
+        for (auto loaded_ws : loaded)
+        {
+            for (auto row : loaded_ws.rows())
+            {
+                for (auto cell : row)
+                {
+                    expected += cell.data_type() == xlnt::cell::type::shared_string ? 1 : 0;
+                }
+            }
+        }
+
+        const auto count = " count=\"" + std::to_string(expected) + "\"";
+        xlnt_assert_differs(saved_part(loaded, "xl/sharedStrings.xml").find(count), std::string::npos);
+    }
+
+    void test_load_reuses_stylesheet_records()
+    {
+        xlnt::workbook wb;
+        wb.load(path_helper::test_file("4_every_style.xlsx"));
+        const auto styles = saved_part(wb, "xl/styles.xml");
+        auto ws = wb.active_sheet();
+
+        // records read from the stylesheet are found again when an equal one is applied
+        for (auto row : ws.rows())
+        {
+            for (auto cell : row)
+            {
+                if (!cell.has_format()) continue;
+
+                auto target = ws.cell(cell.reference().column_index(), cell.reference().row() + 100);
+                target.font(cell.font());
+                target.fill(cell.fill());
+                target.border(cell.border());
+            }
+        }
+
+        const auto reused = saved_part(wb, "xl/styles.xml");
+
+        for (const auto &records : {"<fonts count=\"", "<fills count=\"", "<borders count=\""})
+        {
+            const auto count = [&records](const std::string &part) {
+                const auto start = part.find(records) + std::string(records).size();
+                return part.substr(start, part.find('"', start) - start);
+            };
+
+            xlnt_assert_differs(styles.find(records), std::string::npos);
+            xlnt_assert_equals(count(reused), count(styles));
+        }
+    }
+
+    void test_save_sheet_data_directly()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value(1.5);
+        ws.cell("B1").value(true);
+        ws.cell("C1").value("text");
+        ws.cell("D1").formula("=A1");
+        ws.cell("E1").error("#N/A");
+        ws.cell("AA1").show_phonetics(true);
+        ws.cell("B3").value(-42);
+        ws.row_properties(2).height = 20.25;
+        ws.row_properties(2).custom_height = true;
+
+        // number, boolean and shared string cells bypass the serializer, the others don't
+        const auto sheet = saved_part(wb, "xl/worksheets/sheet1.xml");
+        xlnt_assert_differs(sheet.find("<sheetData>"
+            "<row r=\"1\" spans=\"1:27\"><c r=\"A1\"><v>1.5</v></c><c r=\"B1\" t=\"b\"><v>1</v></c>"
+            "<c r=\"C1\" t=\"s\"><v>0</v></c><c r=\"D1\"><f>A1</f></c><c r=\"E1\" t=\"e\"><v>#N/A</v></c>"
+            "<c r=\"AA1\" ph=\"1\"/></row>"
+            "<row r=\"2\" spans=\"1:27\" ht=\"20.25\" customHeight=\"1\"/>"
+            "<row r=\"3\" spans=\"1:27\"><c r=\"B3\"><v>-42</v></c></row>"
+            "</sheetData>"), std::string::npos);
+
+        xlnt::workbook empty;
+        xlnt_assert_differs(saved_part(empty, "xl/worksheets/sheet1.xml").find("<sheetData/>"), std::string::npos);
+    }
+
+    void test_save_parallel_compression()
+    {
+        xlnt::save_options parallel;
+        parallel.compression_threads = 3;
+
+        for (const auto &file : {"4_every_style.xlsx", "10_comments_hyperlinks_formulae.xlsx", "14_images.xlsx"})
+        {
+            xlnt::workbook wb;
+            wb.load(path_helper::test_file(file));
+
+            std::vector<std::uint8_t> sequential_data;
+            wb.save(sequential_data);
+
+            std::vector<std::uint8_t> parallel_data;
+            wb.save(parallel_data, parallel);
+
+            xlnt_assert(xml_helper::xlsx_archives_match(sequential_data, parallel_data));
+        }
+
+        // more parts than the writer keeps pending, so earlier ones are written while
+        // later ones are still being compressed
+        xlnt::workbook wb;
+        for (auto i = 0; i < 20; ++i)
+        {
+            auto ws = i == 0 ? wb.active_sheet() : wb.create_sheet();
+            for (xlnt::row_t row = 1; row <= 200; ++row)
+            {
+                ws.cell(1, row).value(static_cast<int>(row) * i);
+                ws.cell(2, row).value("row " + std::to_string(row));
+            }
+        }
+
+        std::vector<std::uint8_t> sequential_data;
+        wb.save(sequential_data);
+
+        std::vector<std::uint8_t> parallel_data;
+        wb.save(parallel_data, parallel);
+
+        xlnt_assert(xml_helper::xlsx_archives_match(sequential_data, parallel_data));
+
+        xlnt::workbook reloaded;
+        reloaded.load(parallel_data);
+        xlnt_assert_equals(reloaded.sheet_count(), 20);
+        xlnt_assert_equals(reloaded.sheet_by_index(19).cell("B200").value<std::string>(), "row 200");
+    }
+
+    void test_save_compression_levels()
+    {
+        xlnt::workbook wb;
+        wb.load(path_helper::test_file("4_every_style.xlsx"));
+
+        std::vector<std::uint8_t> default_data;
+        wb.save(default_data);
+
+        std::vector<std::uint8_t> stored_data;
+
+        for (auto threads : {1, 2})
+        {
+            xlnt::save_options options;
+            options.compression_threads = static_cast<std::size_t>(threads);
+
+            for (auto level : {0, 1, 9})
+            {
+                options.compression_level = level;
+                std::vector<std::uint8_t> data;
+                wb.save(data, options);
+
+                xlnt_assert(xml_helper::xlsx_archives_match(default_data, data));
+                if (level == 0) stored_data = data;
+            }
+
+            options.compression_level = 10;
+            std::vector<std::uint8_t> data;
+            xlnt_assert_throws(wb.save(data, options), xlnt::invalid_parameter);
+        }
+
+        xlnt_assert(stored_data.size() > default_data.size());
+
+        xlnt::save_options store;
+        store.compression_level = 0;
+
+        std::vector<std::uint8_t> streamed_data;
+        {
+            xlnt::streaming_workbook_writer writer;
+            writer.open(streamed_data, store);
+            writer.add_worksheet("stream");
+            writer.add_cell("B2").value("B2!");
+        }
+
+        // stored parts appear in the archive as they were written
+        const auto content_types = std::string("<Types xmlns=");
+        xlnt_assert(std::search(streamed_data.begin(), streamed_data.end(),
+                        content_types.begin(), content_types.end())
+            != streamed_data.end());
+
+        xlnt::workbook streamed;
+        streamed.load(streamed_data);
+        xlnt_assert_equals(streamed.sheet_count(), 1);
+        xlnt_assert_equals(streamed.sheet_by_title("stream").cell("B2").value<std::string>(), "B2!");
+    }
+
     void test_round_trip_rw_encrypted_agile()
     {
         xlnt_assert(round_trip_matches_rw(path_helper::test_file("5_encrypted_agile.xlsx"), "secret"));
@@ -695,6 +1641,140 @@ public:
         }
     }
 
+    void test_streaming_read_matches_load()
+    {
+        const auto path = path_helper::test_file("10_comments_hyperlinks_formulae.xlsx");
+
+        xlnt::workbook loaded;
+        loaded.load(path);
+
+        xlnt::streaming_workbook_reader reader;
+        reader.open(xlnt::path(path));
+
+        for (auto sheet_name : reader.sheet_titles())
+        {
+            auto expected = loaded.sheet_by_title(sheet_name);
+            std::size_t streamed_cells = 0;
+
+            reader.begin_worksheet(sheet_name);
+
+            while (reader.has_cell())
+            {
+                auto cell = reader.read_cell();
+                auto expected_cell = expected.cell(cell.reference());
+                ++streamed_cells;
+
+                xlnt_assert_equals(cell.data_type(), expected_cell.data_type());
+                xlnt_assert_equals(cell.has_formula(), expected_cell.has_formula());
+                xlnt_assert_equals(cell.has_format(), expected_cell.has_format());
+
+                if (cell.has_formula())
+                {
+                    xlnt_assert_equals(cell.formula(), expected_cell.formula());
+                }
+
+                if (cell.has_value())
+                {
+                    xlnt_assert_equals(cell.to_string(), expected_cell.to_string());
+                }
+            }
+
+            reader.end_worksheet();
+
+            std::size_t expected_cells = 0;
+            for (auto row : expected.rows())
+            {
+                for (auto expected_cell : row)
+                {
+                    static_cast<void>(expected_cell);
+                    ++expected_cells;
+                }
+            }
+
+            xlnt_assert_equals(streamed_cells, expected_cells);
+        }
+    }
+
+    void test_streaming_read_batch()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (xlnt::row_t row = 2; row <= 21; ++row)
+        {
+            if (row == 10) continue;
+
+            ws.cell(xlnt::cell_reference("A", row)).value(static_cast<int>(row));
+            if (row % 3 != 0) ws.cell(xlnt::cell_reference("B", row)).value("text " + std::to_string(row));
+            ws.cell(xlnt::cell_reference("C", row)).value(row % 2 == 0);
+            ws.cell(xlnt::cell_reference("D", row)).value("skipped");
+        }
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::streaming_workbook_reader reader;
+        reader.open(data);
+        reader.begin_worksheet("Sheet1");
+
+        xlnt::cell_batch batch;
+        xlnt_assert_equals(reader.read_batch(batch, 3, 7), 7);
+        xlnt_assert_equals(batch.first_row, 2);
+        xlnt_assert_equals(batch.columns.size(), 3);
+
+        const auto &numbers = batch.columns[0];
+        const auto &strings = batch.columns[1];
+        const auto &booleans = batch.columns[2];
+
+        for (std::size_t i = 0; i < batch.rows; ++i)
+        {
+            const auto row = batch.first_row + i;
+
+            xlnt_assert(numbers.is_valid(i));
+            xlnt_assert_equals(numbers.types[i], xlnt::cell_type::number);
+            xlnt_assert_equals(numbers.numbers[i], static_cast<double>(row));
+            xlnt_assert_equals(booleans.numbers[i], row % 2 == 0 ? 1.0 : 0.0);
+
+            const auto text = strings.strings.substr(strings.string_offsets[i],
+                strings.string_offsets[i + 1] - strings.string_offsets[i]);
+
+            if (row % 3 != 0)
+            {
+                xlnt_assert(strings.is_valid(i));
+                xlnt_assert_equals(text, "text " + std::to_string(row));
+            }
+            else
+            {
+                xlnt_assert(!strings.is_valid(i));
+                xlnt_assert(text.empty());
+            }
+        }
+
+        // the first cell of the next batch can also be read on its own
+        xlnt_assert(reader.has_cell());
+        xlnt_assert_equals(reader.read_cell().reference(), "A9");
+
+        xlnt_assert_equals(reader.read_batch(batch, 3, 4), 4);
+        xlnt_assert_equals(batch.first_row, 9);
+        xlnt_assert(!batch.columns[0].is_valid(0));
+        xlnt_assert(batch.columns[2].is_valid(0));
+
+        // rows missing from the sheet are included without any valid cells
+        xlnt_assert(!batch.columns[0].is_valid(1));
+        xlnt_assert(!batch.columns[2].is_valid(1));
+        xlnt_assert_equals(batch.columns[2].types[1], xlnt::cell_type::empty);
+        xlnt_assert_equals(batch.columns[0].numbers[2], 11.0);
+
+        std::size_t rows = batch.rows;
+        while (reader.read_batch(batch, 3, 4) > 0)
+        {
+            rows += batch.rows;
+        }
+
+        xlnt_assert_equals(rows, 13);
+        reader.end_worksheet();
+    }
+
     void test_streaming_write()
     {
         const auto path = std::string("stream-out.xlsx");
@@ -710,6 +1790,63 @@ public:
         auto c3 = writer.add_cell("C3");
         b2.value("should not change");
         c3.value("C3!");
+
+        writer.close();
+
+        xlnt::workbook wb;
+        wb.load(path);
+        auto ws = wb.sheet_by_title("stream");
+        xlnt_assert_equals(ws.cell("B2").value<std::string>(), "B2!");
+        xlnt_assert_equals(ws.cell("C3").value<std::string>(), "C3!");
+    }
+
+    void test_streaming_write_rows()
+    {
+        std::vector<std::uint8_t> data;
+        xlnt::streaming_workbook_writer writer;
+        writer.open(data);
+
+        auto numbers = writer.add_worksheet("numbers");
+        numbers.column_properties("B").width = 20.0;
+        const auto bold = writer.workbook_->create_format().font(xlnt::font().bold(true), true);
+        const xlnt::row_t rows = 5000;
+
+        for (xlnt::row_t row = 1; row <= rows; ++row)
+        {
+            writer.add_cell(xlnt::cell_reference("A", row)).value(static_cast<int>(row));
+            auto b = writer.add_cell(xlnt::cell_reference("B", row));
+            b.value("row " + std::to_string(row % 10));
+            if (row % 2 == 0) b.format(bold);
+        }
+
+        xlnt_assert_throws(writer.add_cell("A1"), xlnt::invalid_parameter);
+        xlnt_assert_throws(writer.add_cell(xlnt::cell_reference("B", rows)), xlnt::invalid_parameter);
+
+        writer.add_worksheet("empty");
+        writer.add_worksheet("formulae");
+        writer.add_cell("C1").value(true);
+        writer.add_cell("A3").formula("=SUM(numbers!A1:A10)");
+        writer.close();
+
+        xlnt::workbook wb;
+        wb.load(data);
+
+        xlnt_assert_equals(wb.sheet_titles(), std::vector<std::string>({"numbers", "empty", "formulae"}));
+
+        auto ws = wb.sheet_by_title("numbers");
+        xlnt_assert_equals(ws.highest_row(), rows);
+        xlnt_assert_equals(ws.cell("A4999").value<int>(), 4999);
+        xlnt_assert_equals(ws.cell("B4999").value<std::string>(), "row 9");
+        xlnt_assert(!ws.cell("B4999").has_format());
+        xlnt_assert(ws.cell("B5000").font().bold());
+        xlnt_assert_delta(ws.column_properties("B").width.value(), 20.0, 1.0);
+        xlnt_assert_equals(wb.shared_strings().size(), 10);
+
+        xlnt_assert(!wb.sheet_by_title("empty").has_cell("A1"));
+
+        auto formulae = wb.sheet_by_title("formulae");
+        xlnt_assert(formulae.cell("C1").value<bool>());
+        xlnt_assert_equals(formulae.cell("A3").formula(), "SUM(numbers!A1:A10)");
     }
 
     void test_load_save_german_locale()
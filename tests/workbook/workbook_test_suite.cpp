@@ -65,6 +65,10 @@ public:
         register_test(test_manifest);
         register_test(test_memory);
         register_test(test_clear);
+        register_test(test_format_by_index);
+        register_test(test_format_deduplication);
+        register_test(test_deferred_style_garbage_collection);
+        register_test(test_shared_string_interning);
         register_test(test_comparison);
         register_test(test_id_gen);
         register_test(test_load_file);
@@ -434,6 +438,144 @@ public:
         xlnt_assert(wb.sheet_titles().empty());
     }
 
+    void test_format_by_index()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        // index 0 is the default format and the blank formats created along
+        // the way are collected, so the font sizes match the indices
+        for (xlnt::row_t row = 1; row <= 100; ++row)
+        {
+            xlnt::font font;
+            font.size(row);
+            ws.cell(1, row).format(wb.create_format().font(font, true));
+        }
+
+        for (std::size_t index = 1; index <= 100; ++index)
+        {
+            xlnt_assert_equals(wb.format(index).font().size(), static_cast<double>(index));
+        }
+
+        xlnt_assert_throws(wb.format(101), xlnt::invalid_parameter);
+    }
+
+    void test_format_deduplication()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (xlnt::row_t row = 1; row <= 1000; ++row)
+        {
+            xlnt::font font;
+            font.size(10 + row % 10);
+            ws.cell(1, row).font(font);
+            ws.cell(1, row).fill(xlnt::fill::solid(xlnt::rgb_color(0, 0, static_cast<std::uint8_t>(row % 5))));
+            ws.cell(1, row).number_format(xlnt::number_format("0.000"));
+        }
+
+        // equal records are shared, so the format count doesn't grow with the cells
+        xlnt_assert_throws(wb.format(100), xlnt::invalid_parameter);
+
+        const auto number_format_id = ws.cell(1, 1).number_format().id();
+        xlnt_assert(number_format_id >= 164);
+
+        for (xlnt::row_t row = 1; row <= 1000; ++row)
+        {
+            const auto cell = ws.cell(1, row);
+            xlnt_assert_equals(cell.font().size(), static_cast<double>(10 + row % 10));
+            xlnt_assert_equals(cell.fill().pattern_fill().foreground().value().rgb().blue(), row % 5);
+            xlnt_assert_equals(cell.number_format().id(), number_format_id);
+        }
+    }
+
+    void test_deferred_style_garbage_collection()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        xlnt_assert(!wb.style_garbage_collection_deferred());
+        wb.defer_style_garbage_collection();
+        xlnt_assert(wb.style_garbage_collection_deferred());
+
+        for (xlnt::row_t row = 1; row <= 100; ++row)
+        {
+            xlnt::font font;
+            font.size(row);
+            ws.cell(1, row).font(font);
+        }
+
+        // moving every cell off its format leaves the old formats and fonts unused
+        xlnt::font bold;
+        bold.bold(true);
+
+        for (xlnt::row_t row = 1; row <= 100; ++row)
+        {
+            ws.cell(1, row).font(bold);
+        }
+
+        xlnt_assert_throws_nothing(wb.format(101));
+        wb.garbage_collect_styles();
+        xlnt_assert_throws(wb.format(2), xlnt::invalid_parameter);
+
+        for (xlnt::row_t row = 1; row <= 100; ++row)
+        {
+            xlnt_assert(ws.cell(1, row).font().bold());
+        }
+
+        ws.cell(1, 1).font(xlnt::font());
+        xlnt_assert_throws_nothing(wb.format(2));
+        wb.resume_style_garbage_collection();
+        xlnt_assert(!wb.style_garbage_collection_deferred());
+
+        wb.defer_style_garbage_collection();
+        ws.cell(2, 1).font(xlnt::font().italic(true));
+        ws.cell(2, 1).font(bold);
+        xlnt_assert_throws_nothing(wb.format(3));
+
+        // saving collects what was deferred
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+        xlnt_assert_throws(wb.format(3), xlnt::invalid_parameter);
+
+        xlnt::workbook loaded;
+        loaded.load(data);
+
+        xlnt_assert(loaded.active_sheet().cell(1, 100).font().bold());
+        xlnt_assert(loaded.active_sheet().cell(2, 1).font().bold());
+        xlnt_assert(!loaded.active_sheet().cell(1, 1).font().bold());
+    }
+
+    void test_shared_string_interning()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (xlnt::row_t row = 1; row <= 1000; ++row)
+        {
+            ws.cell(1, row).value("string " + std::to_string(row % 100));
+        }
+
+        xlnt_assert_equals(wb.shared_strings().size(), 100);
+        xlnt_assert_equals(ws.cell(1, 150).value<std::string>(), "string 50");
+
+        // "string 1" comes first, so "string 7" is at index 6
+        // plain and rich text forms of the same string are interned together
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("string 7")), 6);
+        xlnt_assert_equals(wb.add_shared_string(std::string("string 7")), 6);
+
+        xlnt::font bold;
+        bold.bold(true);
+        ws.cell(2, 1).value(xlnt::rich_text("string 7", bold));
+        xlnt_assert_equals(wb.shared_strings().size(), 101);
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("string 7", bold)), 100);
+
+        // duplicates are appended but lookups keep returning the first one
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("string 7"), true), 101);
+        xlnt_assert_equals(wb.add_shared_string(std::string("string 7")), 6);
+        xlnt_assert_equals(wb.add_shared_string(std::string("new string")), 102);
+    }
+
     void test_comparison()
     {
         xlnt::workbook wb, wb2;
@@ -96,6 +96,7 @@ public:
         register_test(test_named_range_named_cell_reference);
         register_test(test_iteration_skip_empty);
         register_test(test_dimensions);
+        register_test(test_bounds_after_clear);
         register_test(test_view_properties_serialization);
         register_test(test_clear_cell);
         register_test(test_clear_row);
@@ -1180,6 +1181,50 @@ public:
         xlnt_assert_equals(sheet_range.height(), 35);
     }
 
+    void test_bounds_after_clear()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        auto first = ws.cell("C3");
+        first.value(1);
+
+        // enough cells to span several row blocks, inserted out of order
+        for (xlnt::row_t row = 600; row >= 2; --row)
+        {
+            ws.cell(xlnt::cell_reference(row % 7 + 2, row)).value(static_cast<int>(row));
+        }
+
+        xlnt_assert_equals(first.value<int>(), 1);
+        xlnt_assert_equals(ws.lowest_row(), 2);
+        xlnt_assert_equals(ws.highest_row(), 600);
+        xlnt_assert_equals(ws.lowest_column(), xlnt::column_t("B"));
+        xlnt_assert_equals(ws.highest_column(), xlnt::column_t("H"));
+
+        ws.clear_row(600);
+        ws.clear_cell("B7");
+        ws.clear_row(2);
+
+        xlnt_assert_equals(ws.lowest_row(), 3);
+        xlnt_assert_equals(ws.highest_row(), 599);
+        xlnt_assert_equals(ws.calculate_dimension(), xlnt::range_reference("B3:H599"));
+
+        auto previous = xlnt::cell_reference("A1");
+        for (auto row : ws.rows())
+        {
+            for (auto cell : row)
+            {
+                xlnt_assert(previous.row() < cell.row()
+                    || (previous.row() == cell.row() && previous.column() < cell.column()));
+                previous = cell.reference();
+            }
+        }
+
+        auto copy = wb.copy_sheet(ws);
+        xlnt_assert(copy.compare(ws, false));
+        xlnt_assert_equals(copy.calculate_dimension(), ws.calculate_dimension());
+    }
+
     void test_view_properties_serialization()
     {
         xlnt::workbook wb;